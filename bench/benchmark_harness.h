@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal Google-Benchmark style harness: register functions taking a
+// State&, iterate with `for (auto _ : state)`, and let the runner grow the
+// iteration count until each case runs for at least --min-time seconds.
+namespace benchmark {
+
+template <class T>
+inline void DoNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+inline void ClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+class State {
+public:
+    State(int64_t argument, uint64_t iterationCount) : arg(argument), maxIterations(iterationCount) {}
+
+    int64_t range(size_t = 0) const {
+        return arg;
+    }
+
+    uint64_t iterations() const {
+        return maxIterations;
+    }
+
+    void PauseTiming() {
+        pausedAt = Clock::now();
+    }
+
+    void ResumeTiming() {
+        pausedTotal += Clock::now() - pausedAt;
+    }
+
+    void SetItemsProcessed(uint64_t items) {
+        itemsProcessed = items;
+    }
+
+    void SetBytesProcessed(uint64_t bytes) {
+        bytesProcessed = bytes;
+    }
+
+    void SetLabel(const std::string &text) {
+        label = text;
+    }
+
+    void SkipWithError(const std::string &message) {
+        error = message;
+        remaining = 0;
+    }
+
+    // Non-trivial so `for (auto _ : state)` does not trip -Wunused-variable.
+    struct Value {
+        ~Value() {}
+    };
+
+    struct Iterator {
+        State *state;
+        bool operator!=(const Iterator &) const {
+            return state->keepRunning();
+        }
+        void operator++() {}
+        Value operator*() const {
+            return Value{};
+        }
+    };
+
+    Iterator begin() {
+        remaining = maxIterations;
+        started = false;
+        return Iterator{this};
+    }
+
+    Iterator end() {
+        return Iterator{this};
+    }
+
+    double elapsedSeconds() const {
+        return std::chrono::duration<double>(stoppedAt - startedAt - pausedTotal).count();
+    }
+
+    uint64_t itemsProcessed{0};
+    uint64_t bytesProcessed{0};
+    std::string label;
+    std::string error;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int64_t arg;
+    uint64_t maxIterations;
+    uint64_t remaining{0};
+    bool started{false};
+    Clock::time_point startedAt{};
+    Clock::time_point stoppedAt{};
+    Clock::time_point pausedAt{};
+    Clock::duration pausedTotal{};
+
+    bool keepRunning() {
+        if (!started) {
+            started = true;
+            pausedTotal = Clock::duration::zero();
+            startedAt = Clock::now();
+        }
+        if (remaining == 0) {
+            stoppedAt = Clock::now();
+            return false;
+        }
+        --remaining;
+        return true;
+    }
+};
+
+struct Registration {
+    std::string name;
+    std::function<void(State &)> function;
+    std::vector<int64_t> arguments;
+};
+
+inline std::vector<Registration> &registry() {
+    static std::vector<Registration> registrations;
+    return registrations;
+}
+
+class Registrar {
+public:
+    Registrar(const char *name, void (*function)(State &)) {
+        registry().push_back(Registration{name, function, {}});
+        index = registry().size() - 1;
+    }
+
+    Registrar *Arg(int64_t value) {
+        registry()[index].arguments.push_back(value);
+        return this;
+    }
+
+    // Powers of `multiplier` from lo to hi inclusive, like RangeMultiplier()->Range().
+    Registrar *Range(int64_t lo, int64_t hi, int64_t multiplier = 10) {
+        for (int64_t value = lo; value <= hi; value *= multiplier) {
+            Arg(value);
+            if (value > hi / multiplier) {
+                break;
+            }
+        }
+        return this;
+    }
+
+private:
+    size_t index;
+};
+
+struct RunOptions {
+    double minTime{0.2};
+    int64_t maxArgument{10000000};
+    std::string filter;
+};
+
+inline std::string formatRate(double perSecond, const char *unit) {
+    static const char *prefixes[] = {"", "k", "M", "G", "T"};
+    size_t prefix = 0;
+    while (perSecond >= 1000.0 && prefix + 1 < sizeof(prefixes) / sizeof(prefixes[0])) {
+        perSecond /= 1000.0;
+        ++prefix;
+    }
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%.3g%s%s/s", perSecond, prefixes[prefix], unit);
+    return buffer;
+}
+
+inline int RunSpecifiedBenchmarks(const RunOptions &options) {
+    std::printf("%-48s %15s %12s  %s\n", "Benchmark", "Time", "Iterations", "Counters");
+    std::printf("%s\n", std::string(96, '-').c_str());
+    for (const auto &registration : registry()) {
+        if (!options.filter.empty() && registration.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        std::vector<int64_t> arguments = registration.arguments;
+        if (arguments.empty()) {
+            arguments.push_back(0);
+        }
+        for (int64_t argument : arguments) {
+            if (argument > options.maxArgument) {
+                continue;
+            }
+            uint64_t iterations = 1;
+            State state(argument, iterations);
+            while (true) {
+                state = State(argument, iterations);
+                registration.function(state);
+                double elapsed = state.elapsedSeconds();
+                if (!state.error.empty() || elapsed >= options.minTime || iterations >= 1000000000ULL) {
+                    break;
+                }
+                double scale = elapsed <= 0.0 ? 100.0 : std::min(100.0, std::max(2.0, 1.4 * options.minTime / elapsed));
+                iterations = static_cast<uint64_t>(static_cast<double>(iterations) * scale) + 1;
+            }
+            std::string name = registration.name + (registration.arguments.empty() ? "" : "/" + std::to_string(argument));
+            if (!state.error.empty()) {
+                std::printf("%-48s ERROR: %s\n", name.c_str(), state.error.c_str());
+                continue;
+            }
+            double elapsed = state.elapsedSeconds();
+            double nanosPerIteration = elapsed * 1e9 / static_cast<double>(state.iterations());
+            std::string counters;
+            if (state.itemsProcessed != 0 && elapsed > 0.0) {
+                counters += "items=" + formatRate(static_cast<double>(state.itemsProcessed) / elapsed, "") + " ";
+            }
+            if (state.bytesProcessed != 0 && elapsed > 0.0) {
+                counters += "bytes=" + formatRate(static_cast<double>(state.bytesProcessed) / elapsed, "B") + " ";
+            }
+            counters += state.label;
+            std::printf("%-48s %12.1f ns %12llu  %s\n", name.c_str(), nanosPerIteration,
+                        static_cast<unsigned long long>(state.iterations()), counters.c_str());
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}
+
+inline RunOptions ParseOptions(int argc, char **argv) {
+    RunOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        auto valueOf = [&](const std::string &flag) -> const char * {
+            return argument.compare(0, flag.size(), flag) == 0 ? argument.c_str() + flag.size() : nullptr;
+        };
+        const char *value = nullptr;
+        if ((value = valueOf("--benchmark_filter=")) != nullptr) {
+            options.filter = value;
+        } else if ((value = valueOf("--benchmark_min_time=")) != nullptr) {
+            options.minTime = std::stod(value);
+        } else if ((value = valueOf("--max_size=")) != nullptr) {
+            options.maxArgument = std::stoll(value);
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--benchmark_filter=substring] [--benchmark_min_time=seconds] [--max_size=N]\n",
+                         argv[0]);
+            std::exit(1);
+        }
+    }
+    return options;
+}
+
+} // namespace benchmark
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_INNER(a, b)
+#define BENCHMARK(function) \
+    static ::benchmark::Registrar *BENCHMARK_CONCAT(benchmark_registrar_, __LINE__) [[maybe_unused]] = \
+        (new ::benchmark::Registrar(#function, function))
+#define BENCHMARK_MAIN() \
+    int main(int argc, char **argv) { \
+        return ::benchmark::RunSpecifiedBenchmarks(::benchmark::ParseOptions(argc, argv)); \
+    }
@@ -0,0 +1,660 @@
+// Microbenchmarks for the WordScrambleGame engine.
+//
+//   g++ -std=c++17 -O2 -pthread -o engine_benchmark bench/engine_benchmark.cpp
+//   ./engine_benchmark --max_size=100000 --benchmark_filter=CheckGuess
+//
+// Dictionary and leaderboard sizes run from 1k to 10M; large fixtures are
+// built once per size and cached for the rest of the run.
+
+#include "../cgpa_calculator.cpp"
+
+#include <filesystem>
+#include <map>
+#include <unordered_set>
+
+#include "benchmark_harness.h"
+#include "synthetic_data.h"
+
+namespace {
+
+constexpr int64_t kMinSize = 1000;
+constexpr int64_t kMaxSize = 10000000;
+
+string fixturePath(const string &name) {
+    static const filesystem::path directory = [] {
+        filesystem::path path = filesystem::temp_directory_path() / "wordscramble_bench";
+        filesystem::create_directories(path);
+        return path;
+    }();
+    return (directory / name).string();
+}
+
+const vector<string> &wordsOfSize(size_t count) {
+    static map<size_t, vector<string>> cache;
+    auto it = cache.find(count);
+    if (it == cache.end()) {
+        it = cache.emplace(count, synthetic::generateWords(count)).first;
+    }
+    return it->second;
+}
+
+const string &wordFileOfSize(size_t count) {
+    static map<size_t, string> cache;
+    auto it = cache.find(count);
+    if (it == cache.end()) {
+        string path = fixturePath("words_" + to_string(count) + ".txt");
+        synthetic::writeWordFile(path, wordsOfSize(count));
+        it = cache.emplace(count, path).first;
+    }
+    return it->second;
+}
+
+const string &leaderboardFileOfSize(size_t count) {
+    static map<size_t, string> cache;
+    auto it = cache.find(count);
+    if (it == cache.end()) {
+        string path = fixturePath("leaderboard_" + to_string(count) + ".csv");
+        synthetic::writeLeaderboardFile(path, synthetic::generateLeaderboard(count, max<size_t>(count / 10, 1)));
+        it = cache.emplace(count, path).first;
+    }
+    return it->second;
+}
+
+// `count` rows split across kShardCount files, each saved in rank order.
+constexpr size_t kShardCount = 8;
+
+const vector<string> &shardFilesOfSize(size_t count) {
+    static map<size_t, vector<string>> cache;
+    auto it = cache.find(count);
+    if (it == cache.end()) {
+        vector<string> paths;
+        for (size_t shard = 0; shard < kShardCount; ++shard) {
+            size_t rows = count / kShardCount + (shard < count % kShardCount ? 1 : 0);
+            string raw = fixturePath("shard_raw_" + to_string(count) + "_" + to_string(shard) + ".csv");
+            synthetic::writeLeaderboardFile(raw, synthetic::generateLeaderboard(rows, max<size_t>(rows / 10, 1), 77 + shard));
+            WordScrambleGame game;
+            game.loadLeaderboardFromFile(raw);
+            paths.push_back(fixturePath("shard_" + to_string(count) + "_" + to_string(shard) + ".csv"));
+            game.saveLeaderboardToFile(paths.back());
+        }
+        it = cache.emplace(count, std::move(paths)).first;
+    }
+    return it->second;
+}
+
+unique_ptr<WordScrambleGame> makeEngineWithWords(size_t count) {
+    auto game = make_unique<WordScrambleGame>();
+    game->seedRandom(1234);
+    game->loadWordsFromFile(wordFileOfSize(count));
+    return game;
+}
+
+unique_ptr<WordScrambleGame> makeEngineWithLeaderboard(size_t count) {
+    auto game = make_unique<WordScrambleGame>();
+    game->seedRandom(1234);
+    game->setPlayerName("bench");
+    game->loadLeaderboardFromFile(leaderboardFileOfSize(count));
+    return game;
+}
+
+// Cached engines are shared by every benchmark of the same size, so they must
+// keep their size: benchmarks that add words or rows build their own engine
+// with the make* functions above.
+WordScrambleGame &engineWithWords(size_t count) {
+    static map<size_t, unique_ptr<WordScrambleGame>> cache;
+    auto it = cache.find(count);
+    if (it == cache.end()) {
+        it = cache.emplace(count, makeEngineWithWords(count)).first;
+    }
+    return *it->second;
+}
+
+WordScrambleGame &engineWithLeaderboard(size_t count) {
+    static map<size_t, unique_ptr<WordScrambleGame>> cache;
+    auto it = cache.find(count);
+    if (it == cache.end()) {
+        it = cache.emplace(count, makeEngineWithLeaderboard(count)).first;
+    }
+    return *it->second;
+}
+
+const vector<LeaderboardEntry> &entriesOfSize(size_t count) {
+    static map<size_t, vector<LeaderboardEntry>> cache;
+    auto it = cache.find(count);
+    if (it == cache.end()) {
+        vector<LeaderboardEntry> entries;
+        entries.reserve(count);
+        for (const auto &row : synthetic::generateLeaderboard(count, max<size_t>(count / 10, 1))) {
+            LeaderboardEntry entry;
+            entry.name = row.name;
+            entry.score = row.score;
+            entry.games = row.games;
+            entry.attempts = row.attempts;
+            entry.averageTime = row.averageTime;
+            entry.accuracy = row.accuracy;
+            entry.averageGuessTime = row.averageGuessTime;
+            entry.difficulty = static_cast<Difficulty>(row.difficulty);
+            entry.playedAt = row.playedAt;
+            entries.push_back(std::move(entry));
+        }
+        it = cache.emplace(count, std::move(entries)).first;
+    }
+    return it->second;
+}
+
+const LeaderboardColumns &columnsOfSize(size_t count) {
+    static map<size_t, LeaderboardColumns> cache;
+    auto it = cache.find(count);
+    if (it == cache.end()) {
+        LeaderboardColumns columns;
+        columns.reserve(count);
+        for (const auto &entry : entriesOfSize(count)) {
+            columns.append(entry);
+        }
+        it = cache.emplace(count, std::move(columns)).first;
+    }
+    return it->second;
+}
+
+uint64_t fileSize(const string &path) {
+    error_code error;
+    auto size = filesystem::file_size(path, error);
+    return error ? 0 : static_cast<uint64_t>(size);
+}
+
+void BM_IsValidWord(benchmark::State &state) {
+    WordScrambleGame game;
+    vector<string> inputs = synthetic::generateWords(1024, 99);
+    inputs[1] = "a";
+    inputs[2] = "has space";
+    inputs[3] = "digits123";
+    inputs[4] = string(24, 'x');
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.isValidWord(inputs[index++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IsValidWord);
+
+void BM_AddWordNew(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    unique_ptr<WordScrambleGame> game = makeEngineWithWords(size);
+    // Fresh words are drawn from an index range disjoint from the fixture's.
+    static size_t nextIndex = 100000000;
+    vector<string> fresh = synthetic::generateWords(4096, 5, nextIndex);
+    nextIndex += fresh.size();
+    size_t index = 0;
+    size_t added = 0;
+    for (auto _ : state) {
+        if (index == fresh.size()) {
+            state.PauseTiming();
+            // Start over once the dictionary has doubled, so it stays near `size`.
+            if (added >= size) {
+                game = makeEngineWithWords(size);
+                added = 0;
+            }
+            fresh = synthetic::generateWords(4096, 5, nextIndex);
+            nextIndex += fresh.size();
+            index = 0;
+            state.ResumeTiming();
+        }
+        benchmark::DoNotOptimize(game->addWord(fresh[index++]));
+        ++added;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddWordNew)->Range(kMinSize, kMaxSize);
+
+void BM_AddWordDuplicate(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    WordScrambleGame &game = engineWithWords(size);
+    const vector<string> &existing = wordsOfSize(size);
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.addWord(existing[index]));
+        index = index + 1 == existing.size() ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddWordDuplicate)->Range(kMinSize, kMaxSize);
+
+// uniqueWords before and after the flat table: lowercase-keyed node set vs
+// FlatWordSet over handles into the word list. Lookups alternate hits and misses.
+void BM_DedupInsertUnorderedSet(benchmark::State &state) {
+    const vector<string> &source = wordsOfSize(static_cast<size_t>(state.range()));
+    for (auto _ : state) {
+        unordered_set<string> set;
+        for (const auto &word : source) {
+            set.insert(WordScrambleGame::toLowerCase(word));
+        }
+        benchmark::DoNotOptimize(set.size());
+    }
+    state.SetItemsProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_DedupInsertUnorderedSet)->Arg(1000000);
+
+void BM_DedupInsertFlatWordSet(benchmark::State &state) {
+    const vector<string> &source = wordsOfSize(static_cast<size_t>(state.range()));
+    for (auto _ : state) {
+        FlatWordSet set;
+        for (size_t i = 0; i < source.size(); ++i) {
+            set.insertNew(static_cast<uint32_t>(i), caseInsensitiveHash(source[i]));
+        }
+        benchmark::DoNotOptimize(set.size());
+    }
+    state.SetItemsProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_DedupInsertFlatWordSet)->Arg(1000000);
+
+const vector<string> &lookupProbes(size_t count) {
+    static map<size_t, vector<string>> cache;
+    auto it = cache.find(count);
+    if (it == cache.end()) {
+        const vector<string> &present = wordsOfSize(count);
+        vector<string> absent = synthetic::generateWords(count / 2, 77, 200000000);
+        vector<string> probes;
+        for (size_t i = 0; i < absent.size(); ++i) {
+            probes.push_back(present[(i * 7919) % present.size()]);
+            probes.push_back(absent[i]);
+        }
+        it = cache.emplace(count, std::move(probes)).first;
+    }
+    return it->second;
+}
+
+void BM_DedupLookupUnorderedSet(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    const vector<string> &source = wordsOfSize(size);
+    const vector<string> &probes = lookupProbes(size);
+    unordered_set<string> set;
+    for (const auto &word : source) {
+        set.insert(WordScrambleGame::toLowerCase(word));
+    }
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(set.count(WordScrambleGame::toLowerCase(probes[index])));
+        index = index + 1 == probes.size() ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DedupLookupUnorderedSet)->Arg(1000000);
+
+void BM_DedupLookupFlatWordSet(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    const vector<string> &source = wordsOfSize(size);
+    const vector<string> &probes = lookupProbes(size);
+    FlatWordSet set;
+    for (size_t i = 0; i < source.size(); ++i) {
+        set.insertNew(static_cast<uint32_t>(i), caseInsensitiveHash(source[i]));
+    }
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(set.contains(probes[index], source));
+        index = index + 1 == probes.size() ? 0 : index + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DedupLookupFlatWordSet)->Arg(1000000);
+
+void BM_LoadWordsFromFile(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    const string &path = wordFileOfSize(size);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto game = make_unique<WordScrambleGame>();
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(game->loadWordsFromFile(path));
+        state.PauseTiming();
+        game.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    state.SetBytesProcessed(state.iterations() * fileSize(path));
+}
+BENCHMARK(BM_LoadWordsFromFile)->Range(kMinSize, kMaxSize);
+
+void BM_SelectRandomWord(benchmark::State &state) {
+    WordScrambleGame &game = engineWithWords(static_cast<size_t>(state.range()));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.selectRandomWord());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SelectRandomWord)->Range(kMinSize, kMaxSize);
+
+void BM_ScrambleWord(benchmark::State &state) {
+    WordScrambleGame &game = engineWithWords(static_cast<size_t>(state.range()));
+    string word = game.selectRandomWord();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.scrambleWord(word));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScrambleWord)->Range(kMinSize, kMaxSize);
+
+void BM_CheckGuess(benchmark::State &state) {
+    WordScrambleGame &game = engineWithWords(static_cast<size_t>(state.range()));
+    string answer = game.selectRandomWord();
+    string wrong = game.scrambleWord(answer);
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.checkGuess((index++ & 1) != 0 ? answer : wrong));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CheckGuess)->Range(kMinSize, kMaxSize);
+
+void BM_FindBuildableWords(benchmark::State &state) {
+    WordScrambleGame &game = engineWithWords(static_cast<size_t>(state.range()));
+    mt19937_64 rng(11);
+    vector<string> racks(256);
+    for (auto &rack : racks) {
+        for (int i = 0; i < 9; ++i) {
+            rack.push_back(synthetic::randomLetter(rng));
+        }
+    }
+    game.countBuildableWords(racks[0]);
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.countBuildableWords(racks[index++ & 255]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindBuildableWords)->Range(kMinSize, kMaxSize);
+
+void BM_UpdateLeaderboard(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    unique_ptr<WordScrambleGame> game = makeEngineWithLeaderboard(size);
+    size_t appended = 0;
+    for (auto _ : state) {
+        // Every update appends a row; start over once the board has doubled.
+        if (appended == size) {
+            state.PauseTiming();
+            game = makeEngineWithLeaderboard(size);
+            appended = 0;
+            state.ResumeTiming();
+        }
+        game->updateLeaderboard(12.5);
+        ++appended;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UpdateLeaderboard)->Range(kMinSize, kMaxSize);
+
+void BM_LeaderboardRankOf(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    WordScrambleGame &game = engineWithLeaderboard(size);
+    size_t players = max<size_t>(size / 10, 1);
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.leaderboardRankOf("player" + to_string(index++ % players)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LeaderboardRankOf)->Range(kMinSize, kMaxSize);
+
+void BM_LeaderboardAround(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    WordScrambleGame &game = engineWithLeaderboard(size);
+    size_t players = max<size_t>(size / 10, 1);
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.leaderboardAround("player" + to_string(index++ % players), 5));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LeaderboardAround)->Range(kMinSize, kMaxSize);
+
+// Per-difficulty means the obvious way, walking whole entries.
+void BM_AggregateEntries(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    const vector<LeaderboardEntry> &entries = entriesOfSize(size);
+    for (auto _ : state) {
+        LeaderboardAggregate result;
+        double scoreSum = 0.0;
+        double accuracySum = 0.0;
+        double timeSum = 0.0;
+        double guessSum = 0.0;
+        result.minScore = INT32_MAX;
+        result.maxScore = INT32_MIN;
+        for (const auto &entry : entries) {
+            if (entry.difficulty != Difficulty::HARD) {
+                continue;
+            }
+            result.count++;
+            result.minScore = min(result.minScore, entry.score);
+            result.maxScore = max(result.maxScore, entry.score);
+            scoreSum += entry.score;
+            accuracySum += entry.accuracy;
+            timeSum += entry.averageTime;
+            guessSum += entry.averageGuessTime;
+        }
+        result.meanScore = scoreSum / static_cast<double>(result.count);
+        result.meanAccuracy = accuracySum / static_cast<double>(result.count);
+        result.meanAverageTime = timeSum / static_cast<double>(result.count);
+        result.meanGuessTime = guessSum / static_cast<double>(result.count);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_AggregateEntries)->Range(kMinSize, kMaxSize);
+
+void BM_AggregateColumns(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    const LeaderboardColumns &columns = columnsOfSize(size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(columns.aggregate(Difficulty::HARD));
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_AggregateColumns)->Range(kMinSize, kMaxSize);
+
+// Dashboard statistics the obvious way: walk the entries, collect matching
+// values, then sort-free selection for the percentiles.
+void BM_StatisticsNaive(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    const vector<LeaderboardEntry> &entries = entriesOfSize(size);
+    auto summarize = [](vector<double> &values) {
+        ColumnSummary summary;
+        summary.count = values.size();
+        if (values.empty()) {
+            return summary;
+        }
+        summary.min = values[0];
+        summary.max = values[0];
+        double sum = 0.0;
+        for (double value : values) {
+            sum += value;
+            summary.min = min(summary.min, value);
+            summary.max = max(summary.max, value);
+        }
+        summary.mean = sum / static_cast<double>(values.size());
+        for (auto target : {&summary.p50, &summary.p90, &summary.p99}) {
+            double fraction = target == &summary.p50 ? 0.50 : target == &summary.p90 ? 0.90 : 0.99;
+            size_t rank = static_cast<size_t>(ceil(fraction * static_cast<double>(values.size())));
+            auto nth = values.begin() + static_cast<ptrdiff_t>(rank == 0 ? 0 : rank - 1);
+            nth_element(values.begin(), nth, values.end());
+            *target = *nth;
+        }
+        return summary;
+    };
+    for (auto _ : state) {
+        vector<double> scores;
+        vector<double> accuracy;
+        vector<double> guessTimes;
+        for (const auto &entry : entries) {
+            if (entry.difficulty == Difficulty::HARD) {
+                scores.push_back(entry.score);
+                accuracy.push_back(entry.accuracy);
+                guessTimes.push_back(entry.averageGuessTime);
+            }
+        }
+        LeaderboardStatistics statistics;
+        statistics.score = summarize(scores);
+        statistics.accuracy = summarize(accuracy);
+        statistics.averageGuessTime = summarize(guessTimes);
+        benchmark::DoNotOptimize(statistics);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_StatisticsNaive)->Range(kMinSize, kMaxSize);
+
+void BM_StatisticsColumns(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    const LeaderboardColumns &columns = columnsOfSize(size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(columns.statistics(Difficulty::HARD));
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    state.SetLabel(ColumnKernels::levelName(ColumnKernels::detectedLevel()));
+}
+BENCHMARK(BM_StatisticsColumns)->Range(kMinSize, kMaxSize);
+
+// The moments kernels alone, one benchmark per instruction set.
+void runMomentsKernel(benchmark::State &state, SimdLevel simd) {
+    size_t size = static_cast<size_t>(state.range());
+    const LeaderboardColumns &columns = columnsOfSize(size);
+    const uint8_t *levels = columns.difficultyColumn().data();
+    uint8_t hard = static_cast<uint8_t>(Difficulty::HARD);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ColumnKernels::moments(columns.accuracyColumn().data(), levels, size, hard, simd));
+        benchmark::DoNotOptimize(ColumnKernels::moments(columns.scoreColumn().data(), levels, size, hard, simd));
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    state.SetLabel(ColumnKernels::levelName(ColumnKernels::usableLevel(simd)));
+}
+
+void BM_MomentsScalar(benchmark::State &state) {
+    runMomentsKernel(state, SimdLevel::SCALAR);
+}
+BENCHMARK(BM_MomentsScalar)->Range(kMinSize, kMaxSize);
+
+void BM_MomentsSSE2(benchmark::State &state) {
+    runMomentsKernel(state, SimdLevel::SSE2);
+}
+BENCHMARK(BM_MomentsSSE2)->Range(kMinSize, kMaxSize);
+
+void BM_MomentsAVX2(benchmark::State &state) {
+    runMomentsKernel(state, SimdLevel::AVX2);
+}
+BENCHMARK(BM_MomentsAVX2)->Range(kMinSize, kMaxSize);
+
+// Bulk ranking as done at the end of loadLeaderboardFromFile(), without the parsing.
+void runAssignLeaderboard(benchmark::State &state, SortAlgorithm algorithm, size_t threads) {
+    size_t size = static_cast<size_t>(state.range());
+    const vector<LeaderboardEntry> &entries = entriesOfSize(size);
+    LeaderboardStore store;
+    store.setSortAlgorithm(algorithm);
+    store.setSortThreads(threads);
+    for (auto _ : state) {
+        state.PauseTiming();
+        vector<LeaderboardEntry> copy = entries;
+        state.ResumeTiming();
+        store.assign(std::move(copy));
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    const char *name = algorithm == SortAlgorithm::RADIX ? "radix" : algorithm == SortAlgorithm::AUTO ? "auto" : "comparison";
+    state.SetLabel(string(name) + ", " + to_string(threads) + " threads");
+}
+
+void BM_AssignLeaderboardSerial(benchmark::State &state) {
+    runAssignLeaderboard(state, SortAlgorithm::COMPARISON, 1);
+}
+BENCHMARK(BM_AssignLeaderboardSerial)->Range(kMinSize, kMaxSize);
+
+void BM_AssignLeaderboardParallel(benchmark::State &state) {
+    runAssignLeaderboard(state, SortAlgorithm::COMPARISON, defaultSortThreads());
+}
+BENCHMARK(BM_AssignLeaderboardParallel)->Range(kMinSize, kMaxSize);
+
+void BM_AssignLeaderboardRadix(benchmark::State &state) {
+    runAssignLeaderboard(state, SortAlgorithm::RADIX, 1);
+}
+BENCHMARK(BM_AssignLeaderboardRadix)->Range(kMinSize, kMaxSize);
+
+void BM_AssignLeaderboardAuto(benchmark::State &state) {
+    runAssignLeaderboard(state, SortAlgorithm::AUTO, defaultSortThreads());
+}
+BENCHMARK(BM_AssignLeaderboardAuto)->Range(kMinSize, kMaxSize);
+
+vector<RankKey> rankKeysOfSize(size_t size) {
+    const vector<LeaderboardEntry> &entries = entriesOfSize(size);
+    vector<RankKey> keys(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        keys[i] = RankKey{entries[i].accuracy, entries[i].score, static_cast<uint32_t>(i)};
+    }
+    return keys;
+}
+
+void runRankKeySort(benchmark::State &state, SortAlgorithm algorithm) {
+    vector<RankKey> keys = rankKeysOfSize(static_cast<size_t>(state.range()));
+    for (auto _ : state) {
+        state.PauseTiming();
+        vector<RankKey> copy = keys;
+        state.ResumeTiming();
+        if (algorithm == SortAlgorithm::RADIX) {
+            radixSortRankKeys(copy);
+        } else {
+            sort(copy.begin(), copy.end(), RankKeyOrder());
+        }
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_RankKeySortComparison(benchmark::State &state) {
+    runRankKeySort(state, SortAlgorithm::COMPARISON);
+}
+BENCHMARK(BM_RankKeySortComparison)->Range(kMinSize, kMaxSize);
+
+void BM_RankKeySortRadix(benchmark::State &state) {
+    runRankKeySort(state, SortAlgorithm::RADIX);
+}
+BENCHMARK(BM_RankKeySortRadix)->Range(kMinSize, kMaxSize);
+
+void BM_SaveLeaderboardToFile(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    WordScrambleGame &game = engineWithLeaderboard(size);
+    string path = fixturePath("leaderboard_save_" + to_string(size) + ".csv");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.saveLeaderboardToFile(path));
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    state.SetBytesProcessed(state.iterations() * fileSize(path));
+}
+BENCHMARK(BM_SaveLeaderboardToFile)->Range(kMinSize, kMaxSize);
+
+void BM_LoadLeaderboardFromFile(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    const string &path = leaderboardFileOfSize(size);
+    WordScrambleGame game;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.loadLeaderboardFromFile(path));
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    state.SetBytesProcessed(state.iterations() * fileSize(path));
+}
+BENCHMARK(BM_LoadLeaderboardFromFile)->Range(kMinSize, kMaxSize);
+
+void BM_MergeLeaderboardShards(benchmark::State &state) {
+    size_t size = static_cast<size_t>(state.range());
+    const vector<string> &shards = shardFilesOfSize(size);
+    string path = fixturePath("leaderboard_merged_" + to_string(size) + ".csv");
+    WordScrambleGame game;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(game.mergeLeaderboardFiles(shards, path));
+    }
+    uint64_t bytes = 0;
+    for (const string &shard : shards) {
+        bytes += fileSize(shard);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetLabel(to_string(kShardCount) + " shards");
+}
+BENCHMARK(BM_MergeLeaderboardShards)->Range(kMinSize, kMaxSize);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,325 @@
+// Load generator: drives the engine with synthetic players through full
+// rounds (select, scramble, hints, guesses, scoring, leaderboard update) and
+// reports engine throughput and per-operation latency percentiles.
+//
+//   g++ -std=c++17 -O2 -pthread -o load_simulator bench/load_simulator.cpp
+//   ./load_simulator --players=5000 --rounds=20 --threads=8 --think-time=lognormal:8:0.6
+//
+// Each worker thread owns one engine (a game server) and a slice of the
+// players. Think time is simulated on a virtual clock rather than slept, so
+// the run measures engine cost only; the virtual round durations are used
+// to estimate how many concurrent players that throughput would sustain.
+
+#include "../cgpa_calculator.cpp"
+
+#include <queue>
+#include <thread>
+
+#include "synthetic_data.h"
+
+namespace {
+
+struct ThinkTimeDistribution {
+    string kind{"lognormal"};
+    double first{8.0};
+    double second{0.6};
+
+    // Milliseconds of simulated think time before a guess.
+    double sample(mt19937_64 &rng) const {
+        if (kind == "fixed") {
+            return first;
+        }
+        if (kind == "uniform") {
+            return uniform_real_distribution<double>(first, second)(rng);
+        }
+        if (kind == "exp") {
+            return exponential_distribution<double>(1.0 / first)(rng);
+        }
+        return lognormal_distribution<double>(first, second)(rng);
+    }
+
+    static bool parse(const string &spec, ThinkTimeDistribution &out) {
+        vector<string> parts;
+        string token;
+        stringstream stream(spec);
+        while (getline(stream, token, ':')) {
+            parts.push_back(token);
+        }
+        if (parts.empty()) {
+            return false;
+        }
+        try {
+            out.kind = parts[0];
+            if (out.kind == "fixed" || out.kind == "exp") {
+                if (parts.size() != 2) {
+                    return false;
+                }
+                out.first = stod(parts[1]);
+                return true;
+            }
+            if (out.kind == "uniform" || out.kind == "lognormal") {
+                if (parts.size() != 3) {
+                    return false;
+                }
+                out.first = stod(parts[1]);
+                out.second = stod(parts[2]);
+                return true;
+            }
+        } catch (const exception &) {
+        }
+        return false;
+    }
+};
+
+struct SimulationOptions {
+    size_t players{1000};
+    size_t roundsPerPlayer{10};
+    size_t threads{max(1u, thread::hardware_concurrency())};
+    size_t dictionarySize{100000};
+    size_t maxGuessesPerRound{5};
+    double accuracy{0.6};
+    double hintRate{0.3};
+    Difficulty difficulty{Difficulty::MEDIUM};
+    LeaderboardMode leaderboardMode{LeaderboardMode::APPEND_ALL};
+    ThinkTimeDistribution thinkTime;
+    uint64_t seed{2024};
+};
+
+enum Operation {
+    OP_SELECT,
+    OP_SCRAMBLE,
+    OP_HINT,
+    OP_GUESS,
+    OP_SCORE,
+    OP_LEADERBOARD,
+    OP_ROUND,
+    OP_COUNT
+};
+
+const char *const kOperationNames[OP_COUNT] = {"select", "scramble", "hint", "guess", "score", "leaderboard", "round"};
+
+struct WorkerResult {
+    array<LatencyHistogram, OP_COUNT> latency;
+    LatencyHistogram virtualRoundMs;
+    uint64_t rounds{0};
+    uint64_t guesses{0};
+    uint64_t hints{0};
+    uint64_t solved{0};
+    Metrics engineMetrics;
+};
+
+struct PlayerState {
+    string name;
+    double virtualClockMs{0.0};
+    size_t roundsLeft{0};
+};
+
+template <class Function>
+auto timed(LatencyHistogram &histogram, Function &&function) {
+    uint64_t start = MetricsClock::now();
+    auto result = function();
+    histogram.record(MetricsClock::elapsed(start, MetricsClock::now()));
+    return result;
+}
+
+void runWorker(const SimulationOptions &options, const vector<string> &dictionary, size_t firstPlayer, size_t playerCount,
+               size_t workerIndex, WorkerResult &result) {
+    WordScrambleGame game;
+    game.seedRandom(static_cast<unsigned>(options.seed + workerIndex));
+    game.setDifficulty(options.difficulty);
+    game.setLeaderboardMode(options.leaderboardMode);
+    for (const auto &word : dictionary) {
+        game.addWord(word);
+    }
+    mt19937_64 rng(options.seed * 31 + workerIndex);
+    bernoulli_distribution guessCorrect(options.accuracy);
+    bernoulli_distribution wantsHint(options.hintRate);
+    uniform_int_distribution<int> hintKind(static_cast<int>(HintKind::FIRST_LETTER), static_cast<int>(HintKind::PATTERN));
+
+    // Players are served in virtual-time order, so leaderboard updates from
+    // different players interleave the way they would on a live server.
+    auto later = [](const PlayerState *lhs, const PlayerState *rhs) {
+        return lhs->virtualClockMs > rhs->virtualClockMs;
+    };
+    vector<PlayerState> players(playerCount);
+    priority_queue<PlayerState *, vector<PlayerState *>, decltype(later)> schedule(later);
+    for (size_t i = 0; i < playerCount; ++i) {
+        players[i].name = "player" + to_string(firstPlayer + i);
+        players[i].roundsLeft = options.roundsPerPlayer;
+        players[i].virtualClockMs = options.thinkTime.sample(rng);
+        schedule.push(&players[i]);
+    }
+
+    while (!schedule.empty()) {
+        PlayerState *player = schedule.top();
+        schedule.pop();
+        double roundVirtualMs = 0.0;
+        uint64_t roundStart = MetricsClock::now();
+
+        game.resetSession();
+        game.setPlayerName(player->name);
+        string word = timed(result.latency[OP_SELECT], [&] { return game.selectRandomWord(); });
+        string scrambled = timed(result.latency[OP_SCRAMBLE], [&] { return game.scrambleWord(word); });
+        bool solved = false;
+        for (size_t attempt = 0; attempt < options.maxGuessesPerRound && !solved; ++attempt) {
+            if (wantsHint(rng)) {
+                HintKind kind = static_cast<HintKind>(hintKind(rng));
+                timed(result.latency[OP_HINT], [&] { return game.requestHint(kind); });
+                result.hints++;
+            }
+            roundVirtualMs += options.thinkTime.sample(rng);
+            const string &guess = guessCorrect(rng) ? word : scrambled;
+            solved = timed(result.latency[OP_GUESS], [&] { return game.checkGuess(guess); });
+            result.guesses++;
+        }
+        if (solved) {
+            timed(result.latency[OP_SCORE], [&] {
+                game.updateScore();
+                return 0;
+            });
+            result.solved++;
+        }
+        timed(result.latency[OP_LEADERBOARD], [&] {
+            game.updateLeaderboard(roundVirtualMs / 1000.0);
+            return 0;
+        });
+        result.latency[OP_ROUND].record(MetricsClock::elapsed(roundStart, MetricsClock::now()));
+        result.virtualRoundMs.record(static_cast<uint64_t>(roundVirtualMs));
+        result.rounds++;
+
+        player->virtualClockMs += roundVirtualMs;
+        if (--player->roundsLeft > 0) {
+            schedule.push(player);
+        }
+    }
+    result.engineMetrics = game.getMetrics();
+}
+
+bool parseOptions(int argc, char **argv, SimulationOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        size_t equals = argument.find('=');
+        if (argument.compare(0, 2, "--") != 0 || equals == string::npos) {
+            return false;
+        }
+        string key = argument.substr(2, equals - 2);
+        string value = argument.substr(equals + 1);
+        try {
+            if (key == "players") {
+                options.players = stoul(value);
+            } else if (key == "rounds") {
+                options.roundsPerPlayer = stoul(value);
+            } else if (key == "threads") {
+                options.threads = max<size_t>(1, stoul(value));
+            } else if (key == "dictionary") {
+                options.dictionarySize = stoul(value);
+            } else if (key == "max-guesses") {
+                options.maxGuessesPerRound = max<size_t>(1, stoul(value));
+            } else if (key == "accuracy") {
+                options.accuracy = clamp(stod(value), 0.0, 1.0);
+            } else if (key == "hint-rate") {
+                options.hintRate = clamp(stod(value), 0.0, 1.0);
+            } else if (key == "difficulty") {
+                int level = stoi(value);
+                if (level < 1 || level > 3) {
+                    return false;
+                }
+                options.difficulty = static_cast<Difficulty>(level);
+            } else if (key == "leaderboard") {
+                if (value == "append") {
+                    options.leaderboardMode = LeaderboardMode::APPEND_ALL;
+                } else if (value == "best") {
+                    options.leaderboardMode = LeaderboardMode::KEEP_BEST;
+                } else if (value == "latest") {
+                    options.leaderboardMode = LeaderboardMode::KEEP_LATEST;
+                } else {
+                    return false;
+                }
+            } else if (key == "think-time") {
+                if (!ThinkTimeDistribution::parse(value, options.thinkTime)) {
+                    return false;
+                }
+            } else if (key == "seed") {
+                options.seed = stoull(value);
+            } else {
+                return false;
+            }
+        } catch (const exception &) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void printUsage(const char *program) {
+    cerr << "usage: " << program << " [--players=N] [--rounds=N] [--threads=N] [--dictionary=N]\n"
+         << "       [--max-guesses=N] [--accuracy=P] [--hint-rate=P] [--difficulty=1|2|3] [--seed=N]\n"
+         << "       [--leaderboard=append|best|latest]\n"
+         << "       [--think-time=fixed:MS|uniform:MIN_MS:MAX_MS|exp:MEAN_MS|lognormal:MU:SIGMA]\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    SimulationOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    options.threads = min(options.threads, max<size_t>(options.players, 1));
+
+    vector<string> dictionary = synthetic::generateWords(options.dictionarySize, options.seed);
+
+    vector<WorkerResult> results(options.threads);
+    vector<thread> workers;
+    uint64_t start = MetricsClock::now();
+    size_t assigned = 0;
+    for (size_t i = 0; i < options.threads; ++i) {
+        size_t share = options.players / options.threads + (i < options.players % options.threads ? 1 : 0);
+        workers.emplace_back(runWorker, cref(options), cref(dictionary), assigned, share, i, ref(results[i]));
+        assigned += share;
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    double wallSeconds = static_cast<double>(MetricsClock::elapsed(start, MetricsClock::now())) / 1e9;
+
+    WorkerResult total;
+    for (const auto &result : results) {
+        for (size_t op = 0; op < OP_COUNT; ++op) {
+            total.latency[op].merge(result.latency[op]);
+        }
+        total.virtualRoundMs.merge(result.virtualRoundMs);
+        total.rounds += result.rounds;
+        total.guesses += result.guesses;
+        total.hints += result.hints;
+        total.solved += result.solved;
+        total.engineMetrics.merge(result.engineMetrics);
+    }
+
+    // Engine-side round time (excluding per-thread dictionary setup) bounds throughput.
+    double engineSeconds = static_cast<double>(total.latency[OP_ROUND].sum()) / 1e9 / static_cast<double>(options.threads);
+    double roundsPerSecond = engineSeconds > 0.0 ? static_cast<double>(total.rounds) / engineSeconds : 0.0;
+    double meanRoundSeconds = total.virtualRoundMs.mean() / 1000.0;
+
+    cout << "players=" << options.players << " rounds/player=" << options.roundsPerPlayer << " threads=" << options.threads
+         << " dictionary=" << options.dictionarySize << " think-time=" << options.thinkTime.kind << '\n';
+    cout << "wall time:          " << fixed << setprecision(3) << wallSeconds << " s (includes dictionary load)\n";
+    cout << "rounds:             " << total.rounds << " (" << total.solved << " solved)\n";
+    cout << "guesses:            " << total.guesses << ", hints: " << total.hints << '\n';
+    cout << "engine throughput:  " << fixed << setprecision(0) << roundsPerSecond << " rounds/s, "
+         << (engineSeconds > 0.0 ? static_cast<double>(total.guesses) / engineSeconds : 0.0) << " guesses/s\n";
+    cout << "virtual round time: mean " << setprecision(2) << meanRoundSeconds << " s, p99 "
+         << static_cast<double>(total.virtualRoundMs.percentile(99.0)) / 1000.0 << " s\n";
+    cout << "sustainable players at that throughput: ~" << setprecision(0) << roundsPerSecond * meanRoundSeconds << '\n';
+    cout << '\n' << left << setw(14) << "operation" << setw(12) << "count" << setw(12) << "p50" << setw(12) << "p90"
+         << setw(12) << "p99" << setw(12) << "p999" << "max\n";
+    for (size_t op = 0; op < OP_COUNT; ++op) {
+        const LatencyHistogram &histogram = total.latency[op];
+        cout << left << setw(14) << kOperationNames[op] << setw(12) << histogram.count() << setw(12)
+             << formatDuration(histogram.percentile(50.0)) << setw(12) << formatDuration(histogram.percentile(90.0)) << setw(12)
+             << formatDuration(histogram.percentile(99.0)) << setw(12) << formatDuration(histogram.percentile(99.9))
+             << formatDuration(histogram.max()) << '\n';
+    }
+    return 0;
+}
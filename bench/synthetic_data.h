@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Deterministic word and leaderboard generators so benchmark and simulator
+// inputs are identical across machines and runs.
+namespace synthetic {
+
+// Roughly English letter frequencies, so scrambles and anagram classes look realistic.
+inline char randomLetter(std::mt19937_64 &rng) {
+    static const char table[] = "eeeeeeeeeeeetttttttttaaaaaaaaooooooooiiiiiiinnnnnnnsssssshhhhhhrrrrrrddddllllcccuuummwwffggyyppbbvkjxqz";
+    std::uniform_int_distribution<size_t> pick(0, sizeof(table) - 2);
+    return table[pick(rng)];
+}
+
+// Word i is a random 0-12 letter prefix followed by a fixed-width base-26
+// encoding of i, which keeps every word unique (case-insensitively) and
+// within the engine's 2-20 letter limit.
+inline std::vector<std::string> generateWords(size_t count, uint64_t seed = 42, size_t firstIndex = 0) {
+    std::mt19937_64 rng(seed ^ (firstIndex * 0x9E3779B97F4A7C15ULL));
+    std::uniform_int_distribution<int> prefixLength(0, 12);
+    std::uniform_int_distribution<int> capitalise(0, 9);
+    std::vector<std::string> words;
+    words.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string word;
+        int length = prefixLength(rng);
+        for (int j = 0; j < length; ++j) {
+            word.push_back(randomLetter(rng));
+        }
+        size_t index = firstIndex + i;
+        for (int j = 0; j < 6; ++j) {
+            word.push_back(static_cast<char>('a' + index % 26));
+            index /= 26;
+        }
+        if (capitalise(rng) == 0) {
+            word[0] = static_cast<char>(word[0] - 'a' + 'A');
+        }
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+inline bool writeWordFile(const std::string &path, const std::vector<std::string> &words) {
+    std::ofstream output(path, std::ios::binary);
+    std::string buffer;
+    for (const auto &word : words) {
+        buffer.append(word).push_back('\n');
+    }
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(output);
+}
+
+struct LeaderboardRow {
+    std::string name;
+    int score;
+    int games;
+    int attempts;
+    double averageTime;
+    double accuracy;
+    double averageGuessTime;
+    int difficulty;
+    int64_t playedAt;
+};
+
+// Synthetic games are spread over the two weeks leading up to this instant.
+constexpr int64_t kSyntheticEpoch = 1767225600; // 2026-01-01T00:00:00Z
+
+inline std::vector<LeaderboardRow> generateLeaderboard(size_t count, size_t players, uint64_t seed = 7) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<size_t> player(0, players == 0 ? 0 : players - 1);
+    std::uniform_int_distribution<int> score(0, 5000);
+    std::uniform_int_distribution<int> games(1, 500);
+    std::uniform_int_distribution<int> attempts(1, 40);
+    std::uniform_real_distribution<double> seconds(1.0, 120.0);
+    std::uniform_real_distribution<double> accuracy(0.0, 100.0);
+    std::uniform_int_distribution<int> difficulty(1, 3);
+    std::uniform_int_distribution<int64_t> age(0, 14 * 86400 - 1);
+    std::vector<LeaderboardRow> rows;
+    rows.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        rows.push_back(LeaderboardRow{"player" + std::to_string(player(rng)), score(rng), games(rng), attempts(rng),
+                                      seconds(rng), accuracy(rng), seconds(rng) * 1000.0, difficulty(rng), kSyntheticEpoch - age(rng)});
+    }
+    return rows;
+}
+
+// Same CSV layout as WordScrambleGame::saveLeaderboardToFile(); rows need not be sorted.
+inline bool writeLeaderboardFile(const std::string &path, const std::vector<LeaderboardRow> &rows) {
+    std::ofstream output(path, std::ios::binary);
+    std::string buffer = "RANK,NAME,SCORE,GAMES,ATTEMPTS,AVG_TIME,ACCURACY,AVG_GUESS_TIME,DIFFICULTY,PLAYED_AT\n";
+    char line[256];
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto &row = rows[i];
+        int length = std::snprintf(line, sizeof(line), "%zu,%s,%d,%d,%d,%.2f,%.2f,%.2f,%d,%lld\n", i + 1, row.name.c_str(), row.score,
+                                   row.games, row.attempts, row.averageTime, row.accuracy, row.averageGuessTime, row.difficulty,
+                                   static_cast<long long>(row.playedAt));
+        buffer.append(line, static_cast<size_t>(length));
+    }
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(output);
+}
+
+} // namespace synthetic
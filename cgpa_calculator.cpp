@@ -1,18 +1,46 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <charconv>
 #include <chrono>
 #include <cmath>
 #include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <queue>
 #include <random>
 #include <regex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define WORDSCRAMBLE_HAS_X86_DISPATCH 1
+#endif
+
+#if defined(WORDSCRAMBLE_USE_TSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define WORDSCRAMBLE_HAS_TSC 1
+#endif
+
 using namespace std;
 using namespace std::chrono;
 
@@ -22,37 +50,2988 @@ enum class Difficulty {
     HARD = 3
 };
 
-struct Metrics {
-    double totalGuessTime{0.0};
-    size_t guessCount{0};
-    size_t fileOperations{0};
-    double totalFileIOTime{0.0};
-    size_t totalMemoryAllocated{0};
-    size_t peakMemoryUsage{0};
-    size_t scrambleCount{0};
+enum class HintKind {
+    FIRST_LETTER = 1,
+    FIRST_AND_LAST = 2,
+    NEXT_LETTER = 3,
+    RAREST_LETTER = 4,
+    VOWELS = 5,
+    PATTERN = 6
+};
+
+enum class HintStatus {
+    REVEALED,
+    NO_WORD,
+    EXHAUSTED,
+    NOT_APPLICABLE
+};
+
+// Outcome of one hint request. `position`/`letter` describe the last letter
+// the hint gave away; `revealedMask` has a bit per position revealed by this
+// hint and `remaining` counts letters still hidden afterwards.
+struct HintResult {
+    HintKind kind{HintKind::NEXT_LETTER};
+    HintStatus status{HintStatus::NO_WORD};
+    uint8_t position{0};
+    char letter{'\0'};
+    uint8_t remaining{0};
+    uint64_t revealedMask{0};
+};
+
+// APPEND_ALL records every finished game; the upsert modes keep one row per player.
+enum class LeaderboardMode {
+    APPEND_ALL,
+    KEEP_BEST,
+    KEEP_LATEST
+};
+
+// Calendar periods for windowed boards, in UTC; weeks start on Monday.
+enum class LeaderboardWindow {
+    DAILY = 0,
+    WEEKLY = 1
+};
+
+enum class MetricsFormat {
+    TEXT,
+    PROMETHEUS,
+    JSON
+};
+
+inline unsigned highestBitIndex(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned index = 0;
+    while (value >>= 1) {
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// value must be non-zero.
+inline unsigned countTrailingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#else
+    unsigned index = 0;
+    while ((value & 1u) == 0) {
+        value >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+inline unsigned countTrailingOnes(uint64_t value) {
+    return value == UINT64_MAX ? 64u : countTrailingZeros(~value);
+}
+
+// High 64 bits of the 128-bit product, e.g. to map a hash onto [0, n).
+inline uint64_t multiplyHigh(uint64_t lhs, uint64_t rhs) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(lhs) * rhs) >> 64);
+#else
+    uint64_t lhsLow = lhs & 0xFFFFFFFFu;
+    uint64_t lhsHigh = lhs >> 32;
+    uint64_t rhsLow = rhs & 0xFFFFFFFFu;
+    uint64_t rhsHigh = rhs >> 32;
+    uint64_t low = lhsLow * rhsLow;
+    uint64_t middle = lhsHigh * rhsLow + (low >> 32);
+    uint64_t cross = lhsLow * rhsHigh + (middle & 0xFFFFFFFFu);
+    return lhsHigh * rhsHigh + (middle >> 32) + (cross >> 32);
+#endif
+}
+
+inline unsigned popCount(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(value));
+#else
+    unsigned count = 0;
+    for (; value != 0; value &= value - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// Monotonic nanosecond ticks. Uses steady_clock unless built with
+// WORDSCRAMBLE_USE_TSC on x86, in which case the TSC is read directly and
+// converted with a 32.32 fixed-point factor calibrated once at first use.
+class MetricsClock {
+public:
+    static uint64_t now() {
+#ifdef WORDSCRAMBLE_HAS_TSC
+        static const TscCalibration calibration = calibrate();
+        return tscToNanoseconds(__rdtsc(), calibration.baseTicks, calibration.nanosecondsPerTick);
+#else
+        return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    static uint64_t elapsed(uint64_t start, uint64_t end) {
+        return end > start ? end - start : 0;
+    }
+
+#ifdef WORDSCRAMBLE_HAS_TSC
+    // A core whose TSC lags the calibrating core's start reads as time zero
+    // rather than wrapping to a huge tick count.
+    static uint64_t tscToNanoseconds(uint64_t tsc, uint64_t baseTicks, uint64_t nanosecondsPerTick) {
+        uint64_t ticks = tsc > baseTicks ? tsc - baseTicks : 0;
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * nanosecondsPerTick) >> 32);
+    }
+#endif
+
+private:
+#ifdef WORDSCRAMBLE_HAS_TSC
+    struct TscCalibration {
+        uint64_t baseTicks;
+        uint64_t nanosecondsPerTick;
+    };
+
+    static TscCalibration calibrate() {
+        auto wallStart = steady_clock::now();
+        uint64_t tscStart = __rdtsc();
+        while (steady_clock::now() - wallStart < milliseconds(10)) {
+        }
+        uint64_t tscEnd = __rdtsc();
+        auto wallNanos = duration_cast<nanoseconds>(steady_clock::now() - wallStart).count();
+        uint64_t ticks = max<uint64_t>(tscEnd - tscStart, 1);
+        uint64_t scale = (static_cast<uint64_t>(wallNanos) << 32) / ticks;
+        return TscCalibration{tscStart, scale};
+    }
+#endif
+};
+
+inline string formatDuration(uint64_t nanoseconds) {
+    static const pair<const char *, double> units[] = {{"s", 1e9}, {"ms", 1e6}, {"us", 1e3}};
+    ostringstream out;
+    for (const auto &unit : units) {
+        if (static_cast<double>(nanoseconds) >= unit.second) {
+            out << fixed << setprecision(2) << static_cast<double>(nanoseconds) / unit.second << ' ' << unit.first;
+            return out.str();
+        }
+    }
+    out << nanoseconds << " ns";
+    return out.str();
+}
+
+struct TraceEvent {
+    const char *name;
+    uint64_t startNs;
+    uint64_t durationNs;
+    uint32_t threadId;
+};
+
+// Collects completed spans into per-thread buffers (no locking on the hot
+// path) and writes them as Chrome trace-event JSON. Each buffer is a ring of
+// kMaxEventsPerThread spans, so a long-running traced process keeps the most
+// recent spans per thread instead of growing without bound. Buffers are only
+// locked against registration, not against record(): call clear(),
+// eventCount(), droppedCount() and writeChromeTrace() once recording threads
+// are quiescent.
+class TraceRecorder {
+public:
+    static constexpr size_t kMaxEventsPerThread = size_t(1) << 16;
+
+    static TraceRecorder &instance() {
+        static TraceRecorder recorder;
+        return recorder;
+    }
+
+    void record(const char *name, uint64_t startNs, uint64_t durationNs) {
+        ThreadBuffer &buffer = threadBuffer();
+        TraceEvent event{name, startNs, durationNs, buffer.threadId};
+        if (buffer.events.size() < kMaxEventsPerThread) {
+            buffer.events.push_back(event);
+            return;
+        }
+        buffer.events[buffer.next] = event;
+        buffer.next = (buffer.next + 1) % kMaxEventsPerThread;
+        ++buffer.dropped;
+    }
+
+    // Quiescent only, see the class comment.
+    void clear() {
+        lock_guard<mutex> lock(buffersMutex);
+        for (auto &buffer : buffers) {
+            buffer->events.clear();
+            buffer->next = 0;
+            buffer->dropped = 0;
+        }
+    }
+
+    // Spans currently held; quiescent only.
+    size_t eventCount() const {
+        lock_guard<mutex> lock(buffersMutex);
+        size_t total = 0;
+        for (const auto &buffer : buffers) {
+            total += buffer->events.size();
+        }
+        return total;
+    }
+
+    // Spans overwritten by newer ones since the last clear(); quiescent only.
+    uint64_t droppedCount() const {
+        lock_guard<mutex> lock(buffersMutex);
+        uint64_t total = 0;
+        for (const auto &buffer : buffers) {
+            total += buffer->dropped;
+        }
+        return total;
+    }
+
+    bool writeChromeTrace(const string &filename) const {
+        ofstream output(filename, ios::binary);
+        if (!output.is_open()) {
+            return false;
+        }
+        lock_guard<mutex> lock(buffersMutex);
+        string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        char number[32];
+        auto appendMicros = [&](uint64_t nanoseconds) {
+            auto result = to_chars(number, number + sizeof(number), static_cast<double>(nanoseconds) / 1000.0, chars_format::fixed, 3);
+            json.append(number, result.ptr);
+        };
+        for (const auto &buffer : buffers) {
+            for (const auto &event : buffer->events) {
+                json.append(first ? "\n" : ",\n");
+                first = false;
+                json.append("{\"name\":\"").append(event.name).append("\",\"cat\":\"engine\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+                json.append(to_string(event.threadId)).append(",\"ts\":");
+                appendMicros(event.startNs);
+                json.append(",\"dur\":");
+                appendMicros(event.durationNs);
+                json.push_back('}');
+            }
+        }
+        json.append("\n]}\n");
+        output.write(json.data(), static_cast<streamsize>(json.size()));
+        return static_cast<bool>(output);
+    }
+
+private:
+    struct ThreadBuffer {
+        uint32_t threadId{0};
+        vector<TraceEvent> events;
+        // Slot the next span overwrites once `events` is full.
+        size_t next{0};
+        uint64_t dropped{0};
+    };
+
+    mutable mutex buffersMutex;
+    vector<unique_ptr<ThreadBuffer>> buffers;
+
+    ThreadBuffer &threadBuffer() {
+        static thread_local ThreadBuffer *local = nullptr;
+        if (local == nullptr) {
+            lock_guard<mutex> lock(buffersMutex);
+            buffers.push_back(make_unique<ThreadBuffer>());
+            local = buffers.back().get();
+            local->threadId = static_cast<uint32_t>(buffers.size());
+        }
+        return *local;
+    }
+};
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char *spanName) : name(spanName), start(MetricsClock::now()) {}
+
+    ~TraceSpan() {
+        TraceRecorder::instance().record(name, start, MetricsClock::elapsed(start, MetricsClock::now()));
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *name;
+    uint64_t start;
+};
+
+#define WS_TRACE_CONCAT_INNER(a, b) a##b
+#define WS_TRACE_CONCAT(a, b) WS_TRACE_CONCAT_INNER(a, b)
+#ifdef WORDSCRAMBLE_ENABLE_TRACING
+#define WS_TRACE_SPAN(name) TraceSpan WS_TRACE_CONCAT(traceSpan_, __LINE__)(name)
+#else
+#define WS_TRACE_SPAN(name) static_cast<void>(0)
+#endif
+
+// Letter histogram of a word: 26 saturating 4-bit counts, a-m in `low` and
+// n-z in `high`, with the length in low bits 52-57. Built in one pass without
+// allocating. Counts of 15+ set kSaturated, and such signatures need an exact
+// check to confirm a match; words with non-letters get kInvalid.
+struct LetterSignature {
+    static constexpr uint64_t kSaturated = uint64_t{1} << 63;
+    static constexpr uint64_t kInvalid = uint64_t{1} << 62;
+    static constexpr unsigned kLengthShift = 52;
+    static constexpr size_t kMaxLength = 63;
+
+    uint64_t low{0};
+    uint64_t high{0};
+
+    static LetterSignature of(string_view word) {
+        LetterSignature signature;
+        if (word.size() > kMaxLength) {
+            signature.high |= kInvalid;
+            return signature;
+        }
+        for (char ch : word) {
+            unsigned letter = static_cast<unsigned>((static_cast<unsigned char>(ch) | 0x20) - 'a');
+            if (letter >= 26 || !isalpha(static_cast<unsigned char>(ch))) {
+                signature.high |= kInvalid;
+                continue;
+            }
+            uint64_t &half = letter < 13 ? signature.low : signature.high;
+            unsigned shift = (letter % 13) * 4;
+            if (((half >> shift) & 0xF) == 0xF) {
+                signature.high |= kSaturated;
+            } else {
+                half += uint64_t{1} << shift;
+            }
+        }
+        signature.low |= static_cast<uint64_t>(word.size()) << kLengthShift;
+        return signature;
+    }
+
+    unsigned count(unsigned letter) const {
+        const uint64_t &half = letter < 13 ? low : high;
+        return static_cast<unsigned>((half >> ((letter % 13) * 4)) & 0xF);
+    }
+
+    size_t length() const {
+        return static_cast<size_t>((low >> kLengthShift) & kMaxLength);
+    }
+
+    bool saturated() const {
+        return (high & kSaturated) != 0;
+    }
+
+    bool valid() const {
+        return (high & kInvalid) == 0;
+    }
+
+    bool operator==(const LetterSignature &other) const {
+        return low == other.low && high == other.high;
+    }
+
+    bool operator!=(const LetterSignature &other) const {
+        return !(*this == other);
+    }
+};
+
+struct LetterSignatureHash {
+    size_t operator()(const LetterSignature &signature) const {
+        uint64_t mixed = signature.low * 0x9E3779B97F4A7C15ULL ^ (signature.high + 0x632BE59BD9B4E019ULL);
+        mixed ^= mixed >> 29;
+        mixed *= 0xBF58476D1CE4E5B9ULL;
+        return static_cast<size_t>(mixed ^ (mixed >> 32));
+    }
+};
+
+// Answers "which dictionary words can be spelled from these letters" (sub-multiset
+// queries). Entries are sorted by their letter counts taken in rarest-letter-first
+// order, which makes the array an implicit trie: at depth d, the entries under a
+// node form contiguous runs by count of the d-th letter, and any run needing more
+// of that letter than the query holds is skipped whole. Rare letters are usually
+// missing from a query, so most of the dictionary is pruned in the first levels.
+class WordBuilderIndex {
+public:
+    // The index refers back into `words`, which must outlive it unchanged.
+    void build(const vector<string> &words) {
+        source = &words;
+        array<size_t, 26> frequency{};
+        for (const auto &word : words) {
+            uint32_t mask = presenceMask(word);
+            for (unsigned letter = 0; letter < 26; ++letter) {
+                frequency[letter] += (mask >> letter) & 1u;
+            }
+        }
+        for (unsigned i = 0; i < 26; ++i) {
+            order[i] = static_cast<uint8_t>(i);
+        }
+        stable_sort(order.begin(), order.end(), [&](uint8_t lhs, uint8_t rhs) {
+            return frequency[lhs] < frequency[rhs];
+        });
+
+        entries.clear();
+        entries.reserve(words.size());
+        for (size_t i = 0; i < words.size(); ++i) {
+            LetterSignature signature = LetterSignature::of(words[i]);
+            Entry entry;
+            entry.word = static_cast<uint32_t>(i);
+            entry.mask = presenceMask(words[i]);
+            entry.saturated = signature.saturated();
+            for (unsigned depth = 0; depth < 26; ++depth) {
+                uint64_t count = signature.count(order[depth]);
+                if (depth < 16) {
+                    entry.head |= count << (60 - 4 * depth);
+                } else {
+                    entry.tail |= count << (60 - 4 * (depth - 16));
+                }
+            }
+            entries.push_back(entry);
+        }
+        sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) {
+            return lhs.head != rhs.head ? lhs.head < rhs.head : lhs.tail < rhs.tail;
+        });
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+
+    // Calls visit(wordIndex) for every indexed word whose letters are a
+    // sub-multiset of `letters` (case-insensitive; non-letters are ignored).
+    template <class Visitor>
+    void forEachBuildable(string_view letters, Visitor &&visit) const {
+        Query query;
+        for (char ch : letters) {
+            if (!isalpha(static_cast<unsigned char>(ch))) {
+                continue;
+            }
+            unsigned letter = static_cast<unsigned>(tolower(static_cast<unsigned char>(ch)) - 'a');
+            query.exact[letter]++;
+            query.mask |= 1u << letter;
+        }
+        for (unsigned depth = 0; depth < 26; ++depth) {
+            query.available[depth] = static_cast<uint8_t>(min<unsigned>(query.exact[order[depth]], 15));
+        }
+        query.saturated = any_of(query.exact.begin(), query.exact.end(), [](unsigned count) {
+            return count >= 15;
+        });
+        descend(query, 0, entries.size(), 0, visit);
+    }
+
+private:
+    struct Entry {
+        uint64_t head{0};
+        uint64_t tail{0};
+        uint32_t word{0};
+        uint32_t mask{0};
+        bool saturated{false};
+    };
+
+    struct Query {
+        array<unsigned, 26> exact{};
+        array<uint8_t, 26> available{};
+        uint32_t mask{0};
+        bool saturated{false};
+    };
+
+    static constexpr size_t kLinearScanThreshold = 16;
+
+    vector<Entry> entries;
+    array<uint8_t, 26> order{};
+    const vector<string> *source{nullptr};
+
+    static uint32_t presenceMask(string_view word) {
+        uint32_t mask = 0;
+        for (char ch : word) {
+            unsigned letter = static_cast<unsigned>((static_cast<unsigned char>(ch) | 0x20) - 'a');
+            if (letter < 26) {
+                mask |= 1u << letter;
+            }
+        }
+        return mask;
+    }
+
+    static unsigned countAt(const Entry &entry, unsigned depth) {
+        return depth < 16 ? static_cast<unsigned>((entry.head >> (60 - 4 * depth)) & 0xF)
+                          : static_cast<unsigned>((entry.tail >> (60 - 4 * (depth - 16))) & 0xF);
+    }
+
+    bool fits(const Query &query, const Entry &entry, unsigned fromDepth) const {
+        if ((entry.mask & ~query.mask) != 0) {
+            return false;
+        }
+        for (unsigned depth = fromDepth; depth < 26; ++depth) {
+            if (countAt(entry, depth) > query.available[depth]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Saturated (15+) nibbles only bound the real count from below, so a
+    // match involving one is confirmed against the exact letter counts.
+    template <class Visitor>
+    void emit(const Query &query, const Entry &entry, Visitor &visit) const {
+        if (entry.saturated || query.saturated) {
+            array<unsigned, 26> needed{};
+            for (char ch : (*source)[entry.word]) {
+                needed[static_cast<unsigned>(tolower(static_cast<unsigned char>(ch)) - 'a')]++;
+            }
+            for (unsigned letter = 0; letter < 26; ++letter) {
+                if (needed[letter] > query.exact[letter]) {
+                    return;
+                }
+            }
+        }
+        visit(entry.word);
+    }
+
+    template <class Visitor>
+    void descend(const Query &query, size_t lo, size_t hi, unsigned depth, Visitor &visit) const {
+        if (hi - lo <= kLinearScanThreshold || depth == 26) {
+            for (size_t i = lo; i < hi; ++i) {
+                if (fits(query, entries[i], depth)) {
+                    emit(query, entries[i], visit);
+                }
+            }
+            return;
+        }
+        unsigned available = query.available[depth];
+        size_t i = lo;
+        while (i < hi) {
+            unsigned count = countAt(entries[i], depth);
+            if (count > available) {
+                break;
+            }
+            size_t runEnd = static_cast<size_t>(partition_point(entries.begin() + static_cast<ptrdiff_t>(i), entries.begin() + static_cast<ptrdiff_t>(hi),
+                                                                [&](const Entry &entry) { return countAt(entry, depth) <= count; })
+                                                - entries.begin());
+            descend(query, i, runEnd, depth + 1, visit);
+            i = runEnd;
+        }
+    }
 };
 
-struct LeaderboardEntry {
-    int rank{0};
-    string name;
-    int score{0};
-    int games{0};
-    int attempts{0};
-    double averageTime{0.0};
-    double accuracy{0.0};
-    double averageGuessTime{0.0};
-    Difficulty difficulty{Difficulty::EASY};
+// Shortest and longest word the engine accepts; every dictionary source is held to them.
+constexpr size_t kMinWordLength = 2;
+constexpr size_t kMaxWordLength = 20;
+
+// Minimised DAWG over lowercase words. Nodes keep their outgoing edges
+// contiguous, sorted by letter, in `edges` (target << 5 | letter) and record
+// how many words lie below them, which gives membership and prefix walks in
+// O(length) plus O(length * 26) access to the i-th word in sorted order, so
+// sampling a uniform index picks a uniform word.
+class CompactDictionary {
+public:
+    void build(vector<string> source) {
+        for (auto &word : source) {
+            transform(word.begin(), word.end(), word.begin(), [](unsigned char ch) {
+                return static_cast<char>(::tolower(ch));
+            });
+        }
+        sort(source.begin(), source.end());
+        source.erase(unique(source.begin(), source.end()), source.end());
+
+        Builder builder;
+        string previous;
+        for (const auto &word : source) {
+            if (word.size() < kMinWordLength || word.size() > kMaxWordLength
+                || any_of(word.begin(), word.end(), [](char ch) { return ch < 'a' || ch > 'z'; })) {
+                continue;
+            }
+            size_t common = 0;
+            while (common < word.size() && common < previous.size() && word[common] == previous[common]) {
+                ++common;
+            }
+            builder.minimize(common);
+            uint32_t node = builder.unchecked.empty() ? 0 : builder.unchecked.back().child;
+            for (size_t i = common; i < word.size(); ++i) {
+                uint32_t child = builder.newNode();
+                builder.nodes[node].children.emplace_back(static_cast<uint8_t>(word[i] - 'a'), child);
+                builder.unchecked.push_back(Builder::Pending{node, child});
+                node = child;
+            }
+            builder.nodes[node].final = true;
+            previous = word;
+        }
+        builder.minimize(0);
+        freeze(builder);
+    }
+
+    size_t size() const {
+        return wordCount.empty() ? 0 : wordCount[0];
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_t nodeCount() const {
+        return isFinal.size();
+    }
+
+    size_t edgeCount() const {
+        return edges.size();
+    }
+
+    size_t memoryBytes() const {
+        return firstEdge.capacity() * sizeof(uint32_t) + edges.capacity() * sizeof(uint32_t)
+               + wordCount.capacity() * sizeof(uint32_t) + isFinal.capacity();
+    }
+
+    bool contains(string_view word) const {
+        uint32_t node = walk(word);
+        return node != kNoNode && isFinal[node] != 0;
+    }
+
+    bool hasPrefix(string_view prefix) const {
+        return countWithPrefix(prefix) != 0;
+    }
+
+    size_t countWithPrefix(string_view prefix) const {
+        uint32_t node = walk(prefix);
+        return node == kNoNode ? 0 : wordCount[node];
+    }
+
+    vector<string> wordsWithPrefix(string_view prefix, size_t limit) const {
+        vector<string> results;
+        uint32_t node = walk(prefix);
+        if (node == kNoNode || limit == 0) {
+            return results;
+        }
+        string current;
+        for (char ch : prefix) {
+            current.push_back(static_cast<char>(::tolower(static_cast<unsigned char>(ch))));
+        }
+        collect(node, current, results, limit);
+        return results;
+    }
+
+    // Calls visit(word) for every word spelled from a sub-multiset of `letters`,
+    // or from exactly that multiset when `exact` (case-insensitive; non-letters
+    // are ignored). Branches are pruned as soon as a letter runs out.
+    template <class Visitor>
+    void forEachSpelledFrom(string_view letters, bool exact, Visitor &&visit) const {
+        if (isFinal.empty()) {
+            return;
+        }
+        array<unsigned, 26> available{};
+        size_t total = 0;
+        for (char ch : letters) {
+            if (isalpha(static_cast<unsigned char>(ch))) {
+                available[static_cast<unsigned>(tolower(static_cast<unsigned char>(ch)) - 'a')]++;
+                ++total;
+            }
+        }
+        string current;
+        spell(0, available, total, exact, current, visit);
+    }
+
+    // The index-th word in lexicographic order; index must be < size().
+    string wordAt(size_t index) const {
+        string word;
+        uint32_t node = 0;
+        while (true) {
+            if (isFinal[node] != 0) {
+                if (index == 0) {
+                    return word;
+                }
+                --index;
+            }
+            for (uint32_t e = firstEdge[node]; e < firstEdge[node + 1]; ++e) {
+                uint32_t target = edges[e] >> 5;
+                if (index < wordCount[target]) {
+                    word.push_back(static_cast<char>('a' + (edges[e] & 31)));
+                    node = target;
+                    break;
+                }
+                index -= wordCount[target];
+            }
+        }
+    }
+
+    // Size of the saveToFile() image, which is also what loadFromFile() reads.
+    size_t serializedBytes() const {
+        return sizeof(kMagic) + 3 * sizeof(uint32_t) + (firstEdge.size() + edges.size()) * sizeof(uint32_t) + isFinal.size();
+    }
+
+    bool saveToFile(const string &filename) const {
+        ofstream output(filename, ios::binary);
+        if (!output.is_open()) {
+            return false;
+        }
+        uint32_t header[3] = {static_cast<uint32_t>(nodeCount()), static_cast<uint32_t>(edgeCount()), static_cast<uint32_t>(size())};
+        output.write(kMagic, sizeof(kMagic));
+        output.write(reinterpret_cast<const char *>(header), sizeof(header));
+        writeArray(output, firstEdge);
+        writeArray(output, edges);
+        output.write(reinterpret_cast<const char *>(isFinal.data()), static_cast<streamsize>(isFinal.size()));
+        return static_cast<bool>(output);
+    }
+
+    bool loadFromFile(const string &filename) {
+        ifstream input(filename, ios::binary);
+        if (!input.is_open()) {
+            return false;
+        }
+        char magic[sizeof(kMagic)];
+        uint32_t header[3];
+        if (!input.read(magic, sizeof(magic)) || !equal(magic, magic + sizeof(magic), kMagic)
+            || !input.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] == 0) {
+            return false;
+        }
+        // Reject counts the file cannot hold before sizing arrays from them.
+        streamoff offset = input.tellg();
+        input.seekg(0, ios::end);
+        streamoff remaining = input.tellg() - offset;
+        input.seekg(offset);
+        uint64_t needed = (uint64_t{header[0]} + 1 + header[1]) * sizeof(uint32_t) + header[0];
+        if (!input || remaining < 0 || needed > static_cast<uint64_t>(remaining)) {
+            return false;
+        }
+        CompactDictionary loaded;
+        loaded.firstEdge.resize(static_cast<size_t>(header[0]) + 1);
+        loaded.edges.resize(header[1]);
+        loaded.isFinal.resize(header[0]);
+        if (!readArray(input, loaded.firstEdge) || !readArray(input, loaded.edges)
+            || !input.read(reinterpret_cast<char *>(loaded.isFinal.data()), static_cast<streamsize>(loaded.isFinal.size()))) {
+            return false;
+        }
+        if (!loaded.validate() || loaded.size() != header[2]) {
+            return false;
+        }
+        *this = std::move(loaded);
+        return true;
+    }
+
+private:
+    static constexpr uint32_t kNoNode = UINT32_MAX;
+    static constexpr char kMagic[8] = {'W', 'S', 'D', 'A', 'W', 'G', '1', '\n'};
+
+    vector<uint32_t> firstEdge;
+    vector<uint32_t> edges;
+    vector<uint32_t> wordCount;
+    vector<uint8_t> isFinal;
+
+    // Incremental minimisation for sorted input (Daciuk et al.): once a word
+    // diverges from its predecessor, the finished suffix nodes are merged
+    // with identical registered nodes.
+    struct Builder {
+        struct Node {
+            bool final{false};
+            vector<pair<uint8_t, uint32_t>> children;
+        };
+        struct Pending {
+            uint32_t parent;
+            uint32_t child;
+        };
+
+        vector<Node> nodes{Node{}};
+        vector<Pending> unchecked;
+        unordered_map<string, uint32_t> registry;
+
+        uint32_t newNode() {
+            nodes.emplace_back();
+            return static_cast<uint32_t>(nodes.size() - 1);
+        }
+
+        string key(uint32_t id) const {
+            const Node &node = nodes[id];
+            string encoded(1, node.final ? '1' : '0');
+            for (const auto &child : node.children) {
+                encoded.push_back(static_cast<char>(child.first));
+                encoded.append(reinterpret_cast<const char *>(&child.second), sizeof(child.second));
+            }
+            return encoded;
+        }
+
+        void minimize(size_t downTo) {
+            while (unchecked.size() > downTo) {
+                Pending pending = unchecked.back();
+                unchecked.pop_back();
+                auto inserted = registry.emplace(key(pending.child), pending.child);
+                if (!inserted.second) {
+                    nodes[pending.parent].children.back().second = inserted.first->second;
+                    nodes[pending.child] = Node{};
+                }
+            }
+        }
+    };
+
+    void freeze(const Builder &builder) {
+        vector<uint32_t> renumbered(builder.nodes.size(), kNoNode);
+        vector<uint32_t> order;
+        vector<uint32_t> stack{0};
+        renumbered[0] = 0;
+        order.push_back(0);
+        while (!stack.empty()) {
+            uint32_t id = stack.back();
+            stack.pop_back();
+            for (const auto &child : builder.nodes[id].children) {
+                if (renumbered[child.second] == kNoNode) {
+                    renumbered[child.second] = static_cast<uint32_t>(order.size());
+                    order.push_back(child.second);
+                    stack.push_back(child.second);
+                }
+            }
+        }
+        firstEdge.assign(order.size() + 1, 0);
+        edges.clear();
+        isFinal.assign(order.size(), 0);
+        for (size_t i = 0; i < order.size(); ++i) {
+            const auto &node = builder.nodes[order[i]];
+            firstEdge[i] = static_cast<uint32_t>(edges.size());
+            isFinal[i] = node.final ? 1 : 0;
+            for (const auto &child : node.children) {
+                edges.push_back(renumbered[child.second] << 5 | child.first);
+            }
+        }
+        firstEdge[order.size()] = static_cast<uint32_t>(edges.size());
+        computeCounts();
+    }
+
+    void computeCounts() {
+        wordCount.assign(isFinal.size(), kNoNode);
+        vector<pair<uint32_t, bool>> stack{{0, false}};
+        while (!stack.empty()) {
+            auto [node, expanded] = stack.back();
+            stack.pop_back();
+            if (expanded) {
+                uint64_t total = isFinal[node];
+                for (uint32_t e = firstEdge[node]; e < firstEdge[node + 1]; ++e) {
+                    total += wordCount[edges[e] >> 5];
+                }
+                wordCount[node] = static_cast<uint32_t>(min<uint64_t>(total, kNoNode - 1));
+                continue;
+            }
+            if (wordCount[node] != kNoNode) {
+                continue;
+            }
+            stack.emplace_back(node, true);
+            for (uint32_t e = firstEdge[node]; e < firstEdge[node + 1]; ++e) {
+                if (wordCount[edges[e] >> 5] == kNoNode) {
+                    stack.emplace_back(edges[e] >> 5, false);
+                }
+            }
+        }
+    }
+
+    // Rejects files whose edges point outside the node table, form cycles or
+    // spell words shorter than kMinWordLength or longer than kMaxWordLength.
+    bool validate() {
+        size_t nodes = isFinal.size();
+        if (firstEdge.size() != nodes + 1 || firstEdge.back() != edges.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < nodes; ++i) {
+            if (firstEdge[i] > firstEdge[i + 1]) {
+                return false;
+            }
+        }
+        for (uint32_t edge : edges) {
+            if ((edge >> 5) >= nodes || (edge & 31) >= 26) {
+                return false;
+            }
+        }
+        // Words of 0 or 1 letters end at the root or one of its children.
+        if (nodes != 0 && isFinal[0] != 0) {
+            return false;
+        }
+        for (uint32_t e = firstEdge[0]; nodes != 0 && e < firstEdge[1]; ++e) {
+            if (isFinal[edges[e] >> 5] != 0) {
+                return false;
+            }
+        }
+        vector<uint8_t> state(nodes, 0);
+        // Longest path below each finished node; children finish first in a DAG.
+        vector<uint32_t> height(nodes, 0);
+        vector<pair<uint32_t, uint32_t>> stack{{0, firstEdge[0]}};
+        state[0] = 1;
+        while (!stack.empty()) {
+            auto &[node, next] = stack.back();
+            if (next == firstEdge[node + 1]) {
+                for (uint32_t e = firstEdge[node]; e < firstEdge[node + 1]; ++e) {
+                    height[node] = max(height[node], height[edges[e] >> 5] + 1);
+                }
+                if (height[node] > kMaxWordLength) {
+                    return false;
+                }
+                state[node] = 2;
+                stack.pop_back();
+                continue;
+            }
+            uint32_t target = edges[next++] >> 5;
+            if (state[target] == 1) {
+                return false;
+            }
+            if (state[target] == 0) {
+                state[target] = 1;
+                stack.emplace_back(target, firstEdge[target]);
+            }
+        }
+        computeCounts();
+        return true;
+    }
+
+    uint32_t walk(string_view word) const {
+        if (isFinal.empty()) {
+            return kNoNode;
+        }
+        uint32_t node = 0;
+        for (char ch : word) {
+            unsigned letter = static_cast<unsigned>((static_cast<unsigned char>(ch) | 0x20) - 'a');
+            if (letter >= 26) {
+                return kNoNode;
+            }
+            uint32_t next = kNoNode;
+            for (uint32_t e = firstEdge[node]; e < firstEdge[node + 1]; ++e) {
+                if ((edges[e] & 31) == letter) {
+                    next = edges[e] >> 5;
+                    break;
+                }
+            }
+            if (next == kNoNode) {
+                return kNoNode;
+            }
+            node = next;
+        }
+        return node;
+    }
+
+    // Recurses once per letter; build() and validate() cap that at kMaxWordLength.
+    template <class Visitor>
+    void spell(uint32_t node, array<unsigned, 26> &available, size_t remaining, bool exact, string &current, Visitor &visit) const {
+        if (isFinal[node] != 0 && !current.empty() && (!exact || remaining == 0)) {
+            visit(current);
+        }
+        for (uint32_t e = firstEdge[node]; e < firstEdge[node + 1]; ++e) {
+            unsigned letter = edges[e] & 31;
+            if (available[letter] == 0) {
+                continue;
+            }
+            --available[letter];
+            current.push_back(static_cast<char>('a' + letter));
+            spell(edges[e] >> 5, available, remaining - 1, exact, current, visit);
+            current.pop_back();
+            ++available[letter];
+        }
+    }
+
+    // Lexicographic depth-first walk on an explicit stack of (node, next edge).
+    void collect(uint32_t root, string &current, vector<string> &results, size_t limit) const {
+        if (isFinal[root] != 0) {
+            results.push_back(current);
+        }
+        vector<pair<uint32_t, uint32_t>> stack{{root, firstEdge[root]}};
+        while (!stack.empty() && results.size() < limit) {
+            auto &[node, next] = stack.back();
+            if (next == firstEdge[node + 1]) {
+                stack.pop_back();
+                if (!stack.empty()) {
+                    current.pop_back();
+                }
+                continue;
+            }
+            uint32_t edge = edges[next++];
+            uint32_t target = edge >> 5;
+            current.push_back(static_cast<char>('a' + (edge & 31)));
+            if (isFinal[target] != 0) {
+                results.push_back(current);
+            }
+            stack.emplace_back(target, firstEdge[target]);
+        }
+    }
+
+    template <class T>
+    static void writeArray(ostream &output, const vector<T> &values) {
+        output.write(reinterpret_cast<const char *>(values.data()), static_cast<streamsize>(values.size() * sizeof(T)));
+    }
+
+    template <class T>
+    static bool readArray(istream &input, vector<T> &values) {
+        return static_cast<bool>(input.read(reinterpret_cast<char *>(values.data()), static_cast<streamsize>(values.size() * sizeof(T))));
+    }
+};
+
+// Case-insensitive 64-bit hash of an ASCII word, computed without lowercasing a copy.
+inline uint64_t caseInsensitiveHash(string_view word) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (char ch : word) {
+        hash = (hash ^ static_cast<uint64_t>(::tolower(static_cast<unsigned char>(ch)))) * 0x100000001B3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    return hash ^ (hash >> 33);
+}
+
+// Swiss-table style open-addressing set of word handles (indices into an
+// external word list), compared case-insensitively. Control bytes hold 7 bits
+// of hash per slot and are probed 16 at a time with SSE2 where available;
+// slots keep 32 bits of hash so growing never re-reads the words.
+class FlatWordSet {
+public:
+    static constexpr size_t kGroupSize = 16;
+
+    size_t size() const {
+        return count;
+    }
+
+    size_t capacity() const {
+        return slots.size();
+    }
+
+    size_t memoryBytes() const {
+        return control.capacity() + slots.capacity() * sizeof(Slot);
+    }
+
+    void clear() {
+        control.clear();
+        slots.clear();
+        count = 0;
+    }
+
+    void reserve(size_t words) {
+        size_t needed = kGroupSize;
+        while (needed * 7 / 8 < words) {
+            needed *= 2;
+        }
+        if (needed > slots.size()) {
+            rehash(needed);
+        }
+    }
+
+    bool contains(string_view word, const vector<string> &storage) const {
+        return find(word, caseInsensitiveHash(word), storage) != kMissing;
+    }
+
+    bool contains(string_view word, uint64_t hash, const vector<string> &storage) const {
+        return find(word, hash, storage) != kMissing;
+    }
+
+    // Adds storage[handle]; the caller has checked it is not already present.
+    void insertNew(uint32_t handle, uint64_t hash) {
+        if ((count + 1) * 8 > slots.size() * 7) {
+            rehash(max(slots.size() * 2, kGroupSize));
+        }
+        place(Slot{static_cast<uint32_t>(hash >> 32), handle});
+        ++count;
+    }
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t handle;
+    };
+
+    static constexpr int8_t kEmpty = -128;
+    static constexpr uint32_t kMissing = UINT32_MAX;
+
+    vector<int8_t> control;
+    vector<Slot> slots;
+    size_t count{0};
+
+    static int8_t tagOf(uint32_t hash) {
+        return static_cast<int8_t>(hash & 0x7F);
+    }
+
+    size_t groupMask() const {
+        return slots.size() / kGroupSize - 1;
+    }
+
+    // Bit i set where control byte i of the group equals `value`.
+    uint32_t matchGroup(size_t group, int8_t value) const {
+        const int8_t *bytes = control.data() + group * kGroupSize;
+#if defined(__SSE2__)
+        __m128i loaded = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(loaded, _mm_set1_epi8(value))));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < kGroupSize; ++i) {
+            mask |= static_cast<uint32_t>(bytes[i] == value) << i;
+        }
+        return mask;
+#endif
+    }
+
+    static unsigned lowestBit(uint32_t mask) {
+        return countTrailingZeros(mask);
+    }
+
+    uint32_t find(string_view word, uint64_t hash, const vector<string> &storage) const {
+        if (slots.empty()) {
+            return kMissing;
+        }
+        uint32_t shortHash = static_cast<uint32_t>(hash >> 32);
+        int8_t tag = tagOf(shortHash);
+        size_t group = (shortHash >> 7) & groupMask();
+        for (size_t step = 1;; ++step) {
+            for (uint32_t candidates = matchGroup(group, tag); candidates != 0; candidates &= candidates - 1) {
+                const Slot &slot = slots[group * kGroupSize + lowestBit(candidates)];
+                if (slot.hash == shortHash && equalsIgnoreCase(storage[slot.handle], word)) {
+                    return slot.handle;
+                }
+            }
+            if (matchGroup(group, kEmpty) != 0) {
+                return kMissing;
+            }
+            group = (group + step) & groupMask();
+        }
+    }
+
+    void place(const Slot &slot) {
+        size_t group = (slot.hash >> 7) & groupMask();
+        for (size_t step = 1;; ++step) {
+            uint32_t empty = matchGroup(group, kEmpty);
+            if (empty != 0) {
+                size_t index = group * kGroupSize + lowestBit(empty);
+                control[index] = tagOf(slot.hash);
+                slots[index] = slot;
+                return;
+            }
+            group = (group + step) & groupMask();
+        }
+    }
+
+    void rehash(size_t newCapacity) {
+        vector<int8_t> oldControl = std::move(control);
+        vector<Slot> oldSlots = std::move(slots);
+        control.assign(newCapacity, kEmpty);
+        slots.assign(newCapacity, Slot{0, 0});
+        for (size_t i = 0; i < oldSlots.size(); ++i) {
+            if (oldControl[i] != kEmpty) {
+                place(oldSlots[i]);
+            }
+        }
+    }
+
+    static bool equalsIgnoreCase(const string &stored, string_view word) {
+        if (stored.size() != word.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < word.size(); ++i) {
+            if (::tolower(static_cast<unsigned char>(stored[i])) != ::tolower(static_cast<unsigned char>(word[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Blocked Bloom filter: each key maps to one 512-bit (cache line) block and
+// sets kProbes bits inside it, so a query touches a single cache line.
+class BlockedBloomFilter {
+public:
+    static constexpr unsigned kProbes = 6;
+
+    void reset(size_t expectedKeys, size_t bitsPerKey = 12) {
+        size_t blockCount = max<size_t>(1, (expectedKeys * bitsPerKey + 511) / 512);
+        blocks.assign(blockCount, Block{});
+        keys = 0;
+        capacity = expectedKeys;
+    }
+
+    bool empty() const {
+        return blocks.empty();
+    }
+
+    // True once more keys were inserted than the filter was sized for.
+    bool overloaded() const {
+        return keys > capacity;
+    }
+
+    size_t capacityKeys() const {
+        return capacity;
+    }
+
+    void insert(uint64_t hash) {
+        Block &block = blocks[blockIndex(hash)];
+        for (unsigned probe = 0; probe < kProbes; ++probe) {
+            unsigned bit = bitIndex(hash, probe);
+            block.words[bit >> 6] |= uint64_t{1} << (bit & 63);
+        }
+        ++keys;
+    }
+
+    bool mayContain(uint64_t hash) const {
+        const Block &block = blocks[blockIndex(hash)];
+        for (unsigned probe = 0; probe < kProbes; ++probe) {
+            unsigned bit = bitIndex(hash, probe);
+            if ((block.words[bit >> 6] & (uint64_t{1} << (bit & 63))) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t memoryBytes() const {
+        return blocks.capacity() * sizeof(Block);
+    }
+
+private:
+    struct alignas(64) Block {
+        array<uint64_t, 8> words{};
+    };
+
+    vector<Block> blocks;
+    size_t keys{0};
+    size_t capacity{0};
+
+    // The probes consume the low 54 bits, so the block comes from a remix of
+    // the whole hash; otherwise keys sharing a block also share probe bits.
+    size_t blockIndex(uint64_t hash) const {
+        uint64_t mixed = (hash ^ (hash >> 31)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(multiplyHigh(mixed ^ (mixed >> 29), blocks.size()));
+    }
+
+    // Nine bits per probe taken from the low 54 bits of the hash.
+    static unsigned bitIndex(uint64_t hash, unsigned probe) {
+        return static_cast<unsigned>((hash >> (probe * 9)) & 511);
+    }
+};
+
+// Log-linear histogram: exact below 32, then 32 sub-buckets per power of two
+// (~3% relative error). Values are nanoseconds.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 5;
+    static constexpr size_t kSubBucketCount = size_t{1} << kSubBucketBits;
+    static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+    void record(uint64_t value) {
+        counts[bucketIndex(value)]++;
+        total++;
+        sumValue += value;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+    }
+
+    void merge(const LatencyHistogram &other) {
+        if (other.total == 0) {
+            return;
+        }
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sumValue += other.sumValue;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+    }
+
+    void reset() {
+        *this = LatencyHistogram{};
+    }
+
+    uint64_t percentile(double percent) const {
+        if (total == 0) {
+            return 0;
+        }
+        percent = std::clamp(percent, 0.0, 100.0);
+        uint64_t target = static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(total)));
+        target = std::clamp<uint64_t>(target, 1, total);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts[i];
+            if (seen >= target) {
+                return std::clamp(bucketUpperBound(i), minValue, maxValue);
+            }
+        }
+        return maxValue;
+    }
+
+    uint64_t count() const {
+        return total;
+    }
+
+    uint64_t sum() const {
+        return sumValue;
+    }
+
+    uint64_t min() const {
+        return total == 0 ? 0 : minValue;
+    }
+
+    uint64_t max() const {
+        return maxValue;
+    }
+
+    double mean() const {
+        return total == 0 ? 0.0 : static_cast<double>(sumValue) / static_cast<double>(total);
+    }
+
+private:
+    array<uint64_t, kBucketCount> counts{};
+    uint64_t total{0};
+    uint64_t sumValue{0};
+    uint64_t minValue{UINT64_MAX};
+    uint64_t maxValue{0};
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < kSubBucketCount) {
+            return static_cast<size_t>(value);
+        }
+        unsigned shift = highestBitIndex(value) - kSubBucketBits;
+        return (shift + 1) * kSubBucketCount + static_cast<size_t>((value >> shift) - kSubBucketCount);
+    }
+
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < kSubBucketCount) {
+            return index;
+        }
+        unsigned shift = static_cast<unsigned>(index / kSubBucketCount) - 1;
+        uint64_t lower = static_cast<uint64_t>(kSubBucketCount + index % kSubBucketCount) << shift;
+        return lower + ((uint64_t{1} << shift) - 1);
+    }
+};
+
+enum class MemorySubsystem {
+    DICTIONARY,
+    LEADERBOARD,
+    SESSION,
+    OTHER
+};
+
+constexpr size_t kMemorySubsystemCount = 4;
+
+inline const char *memorySubsystemName(MemorySubsystem subsystem) {
+    switch (subsystem) {
+    case MemorySubsystem::DICTIONARY:
+        return "dictionary";
+    case MemorySubsystem::LEADERBOARD:
+        return "leaderboard";
+    case MemorySubsystem::SESSION:
+        return "session";
+    case MemorySubsystem::OTHER:
+        return "other";
+    }
+    return "other";
+}
+
+// Live/peak heap bytes per subsystem. Only fed by the global new/delete hooks
+// compiled in with WORDSCRAMBLE_TRACK_ALLOCATIONS; otherwise it stays at zero.
+class MemoryTracker {
+public:
+    static MemoryTracker &instance() {
+        static MemoryTracker tracker;
+        return tracker;
+    }
+
+    static constexpr bool enabled() {
+#ifdef WORDSCRAMBLE_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static MemorySubsystem &currentSubsystem() {
+        static thread_local MemorySubsystem subsystem = MemorySubsystem::OTHER;
+        return subsystem;
+    }
+
+    void allocated(MemorySubsystem subsystem, size_t bytes) {
+        size_t index = static_cast<size_t>(subsystem);
+        raisePeak(peak[index], live[index].fetch_add(bytes, memory_order_relaxed) + bytes);
+        raisePeak(totalPeak, totalLive.fetch_add(bytes, memory_order_relaxed) + bytes);
+    }
+
+    void released(MemorySubsystem subsystem, size_t bytes) {
+        live[static_cast<size_t>(subsystem)].fetch_sub(bytes, memory_order_relaxed);
+        totalLive.fetch_sub(bytes, memory_order_relaxed);
+    }
+
+    size_t liveBytes(MemorySubsystem subsystem) const {
+        return live[static_cast<size_t>(subsystem)].load(memory_order_relaxed);
+    }
+
+    size_t peakBytes(MemorySubsystem subsystem) const {
+        return peak[static_cast<size_t>(subsystem)].load(memory_order_relaxed);
+    }
+
+    size_t totalLiveBytes() const {
+        return totalLive.load(memory_order_relaxed);
+    }
+
+    size_t totalPeakBytes() const {
+        return totalPeak.load(memory_order_relaxed);
+    }
+
+private:
+    array<atomic<size_t>, kMemorySubsystemCount> live{};
+    array<atomic<size_t>, kMemorySubsystemCount> peak{};
+    atomic<size_t> totalLive{0};
+    atomic<size_t> totalPeak{0};
+
+    static void raisePeak(atomic<size_t> &peakValue, size_t candidate) {
+        size_t observed = peakValue.load(memory_order_relaxed);
+        while (candidate > observed && !peakValue.compare_exchange_weak(observed, candidate, memory_order_relaxed)) {
+        }
+    }
+};
+
+// Attributes allocations made on this thread to a subsystem until destroyed.
+class MemoryScope {
+public:
+    explicit MemoryScope(MemorySubsystem subsystem) : previous(MemoryTracker::currentSubsystem()) {
+        MemoryTracker::currentSubsystem() = subsystem;
+    }
+
+    ~MemoryScope() {
+        MemoryTracker::currentSubsystem() = previous;
+    }
+
+    MemoryScope(const MemoryScope &) = delete;
+    MemoryScope &operator=(const MemoryScope &) = delete;
+
+private:
+    MemorySubsystem previous;
+};
+
+#ifdef WORDSCRAMBLE_TRACK_ALLOCATIONS
+namespace allocation_hooks {
+
+// Each block carries a max_align_t-sized header with its size and owner.
+struct BlockHeader {
+    size_t size;
+    MemorySubsystem subsystem;
+};
+
+constexpr size_t kHeaderSize = alignof(max_align_t) > sizeof(BlockHeader) ? alignof(max_align_t) : sizeof(BlockHeader);
+
+inline void *trackedAllocate(size_t size) noexcept {
+    void *raw = std::malloc(size + kHeaderSize);
+    if (raw == nullptr) {
+        return nullptr;
+    }
+    auto *header = static_cast<BlockHeader *>(raw);
+    header->size = size;
+    header->subsystem = MemoryTracker::currentSubsystem();
+    MemoryTracker::instance().allocated(header->subsystem, size);
+    return static_cast<char *>(raw) + kHeaderSize;
+}
+
+inline void trackedRelease(void *pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    void *raw = static_cast<char *>(pointer) - kHeaderSize;
+    auto *header = static_cast<BlockHeader *>(raw);
+    MemoryTracker::instance().released(header->subsystem, header->size);
+    std::free(raw);
+}
+
+inline void *trackedAllocateOrThrow(size_t size) {
+    void *pointer = trackedAllocate(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        throw bad_alloc();
+    }
+    return pointer;
+}
+
+// Over-aligned blocks pad the malloc'd region so the header sits directly
+// below the aligned address and remembers where the region really starts.
+struct AlignedBlockHeader {
+    void *raw;
+    size_t size;
+    MemorySubsystem subsystem;
+};
+
+inline void *trackedAllocateAligned(size_t size, align_val_t alignment) noexcept {
+    size_t align = static_cast<size_t>(alignment);
+    void *raw = std::malloc(size + align + sizeof(AlignedBlockHeader));
+    if (raw == nullptr) {
+        return nullptr;
+    }
+    uintptr_t first = reinterpret_cast<uintptr_t>(raw) + sizeof(AlignedBlockHeader);
+    char *aligned = reinterpret_cast<char *>((first + align - 1) & ~(uintptr_t(align) - 1));
+    auto *header = reinterpret_cast<AlignedBlockHeader *>(aligned) - 1;
+    header->raw = raw;
+    header->size = size;
+    header->subsystem = MemoryTracker::currentSubsystem();
+    MemoryTracker::instance().allocated(header->subsystem, size);
+    return aligned;
+}
+
+inline void trackedReleaseAligned(void *pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    auto *header = static_cast<AlignedBlockHeader *>(pointer) - 1;
+    MemoryTracker::instance().released(header->subsystem, header->size);
+    std::free(header->raw);
+}
+
+inline void *trackedAllocateAlignedOrThrow(size_t size, align_val_t alignment) {
+    void *pointer = trackedAllocateAligned(size == 0 ? 1 : size, alignment);
+    if (pointer == nullptr) {
+        throw bad_alloc();
+    }
+    return pointer;
+}
+
+} // namespace allocation_hooks
+
+void *operator new(size_t size) {
+    return allocation_hooks::trackedAllocateOrThrow(size);
+}
+
+void *operator new[](size_t size) {
+    return allocation_hooks::trackedAllocateOrThrow(size);
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept {
+    return allocation_hooks::trackedAllocate(size == 0 ? 1 : size);
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept {
+    return allocation_hooks::trackedAllocate(size == 0 ? 1 : size);
+}
+
+void operator delete(void *pointer) noexcept {
+    allocation_hooks::trackedRelease(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    allocation_hooks::trackedRelease(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    allocation_hooks::trackedRelease(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    allocation_hooks::trackedRelease(pointer);
+}
+
+void operator delete(void *pointer, const nothrow_t &) noexcept {
+    allocation_hooks::trackedRelease(pointer);
+}
+
+void operator delete[](void *pointer, const nothrow_t &) noexcept {
+    allocation_hooks::trackedRelease(pointer);
+}
+
+void *operator new(size_t size, align_val_t alignment) {
+    return allocation_hooks::trackedAllocateAlignedOrThrow(size, alignment);
+}
+
+void *operator new[](size_t size, align_val_t alignment) {
+    return allocation_hooks::trackedAllocateAlignedOrThrow(size, alignment);
+}
+
+void *operator new(size_t size, align_val_t alignment, const nothrow_t &) noexcept {
+    return allocation_hooks::trackedAllocateAligned(size == 0 ? 1 : size, alignment);
+}
+
+void *operator new[](size_t size, align_val_t alignment, const nothrow_t &) noexcept {
+    return allocation_hooks::trackedAllocateAligned(size == 0 ? 1 : size, alignment);
+}
+
+void operator delete(void *pointer, align_val_t) noexcept {
+    allocation_hooks::trackedReleaseAligned(pointer);
+}
+
+void operator delete[](void *pointer, align_val_t) noexcept {
+    allocation_hooks::trackedReleaseAligned(pointer);
+}
+
+void operator delete(void *pointer, size_t, align_val_t) noexcept {
+    allocation_hooks::trackedReleaseAligned(pointer);
+}
+
+void operator delete[](void *pointer, size_t, align_val_t) noexcept {
+    allocation_hooks::trackedReleaseAligned(pointer);
+}
+
+void operator delete(void *pointer, align_val_t, const nothrow_t &) noexcept {
+    allocation_hooks::trackedReleaseAligned(pointer);
+}
+
+void operator delete[](void *pointer, align_val_t, const nothrow_t &) noexcept {
+    allocation_hooks::trackedReleaseAligned(pointer);
+}
+#endif
+
+struct Metrics {
+    uint64_t totalGuessTimeNs{0};
+    size_t guessCount{0};
+    size_t fileOperations{0};
+    uint64_t totalFileIOTimeNs{0};
+    size_t totalMemoryAllocated{0};
+    size_t peakMemoryUsage{0};
+    size_t scrambleCount{0};
+    uint64_t bytesRead{0};
+    uint64_t bytesWritten{0};
+    uint64_t dedupFilterQueries{0};
+    uint64_t dedupFilterRejections{0};
+    uint64_t dedupFilterFalsePositives{0};
+    array<size_t, kMemorySubsystemCount> liveBytesBySubsystem{};
+    array<size_t, kMemorySubsystemCount> peakBytesBySubsystem{};
+    LatencyHistogram guessLatency;
+    LatencyHistogram fileIOLatency;
+    LatencyHistogram scoringLatency;
+
+    void merge(const Metrics &other) {
+        totalGuessTimeNs += other.totalGuessTimeNs;
+        guessCount += other.guessCount;
+        fileOperations += other.fileOperations;
+        totalFileIOTimeNs += other.totalFileIOTimeNs;
+        totalMemoryAllocated = max(totalMemoryAllocated, other.totalMemoryAllocated);
+        peakMemoryUsage = max(peakMemoryUsage, other.peakMemoryUsage);
+        scrambleCount += other.scrambleCount;
+        bytesRead += other.bytesRead;
+        bytesWritten += other.bytesWritten;
+        dedupFilterQueries += other.dedupFilterQueries;
+        dedupFilterRejections += other.dedupFilterRejections;
+        dedupFilterFalsePositives += other.dedupFilterFalsePositives;
+        for (size_t i = 0; i < kMemorySubsystemCount; ++i) {
+            liveBytesBySubsystem[i] = max(liveBytesBySubsystem[i], other.liveBytesBySubsystem[i]);
+            peakBytesBySubsystem[i] = max(peakBytesBySubsystem[i], other.peakBytesBySubsystem[i]);
+        }
+        guessLatency.merge(other.guessLatency);
+        fileIOLatency.merge(other.fileIOLatency);
+        scoringLatency.merge(other.scoringLatency);
+    }
+};
+
+struct LeaderboardEntry {
+    int rank{0};
+    string name;
+    int score{0};
+    int games{0};
+    int attempts{0};
+    double averageTime{0.0};
+    double accuracy{0.0};
+    double averageGuessTime{0.0};
+    Difficulty difficulty{Difficulty::EASY};
+    // Unix seconds when the game finished; 0 for rows saved before timestamps existed.
+    int64_t playedAt{0};
+};
+
+// Appends numbers with to_chars so exporters never touch iostreams.
+class MetricsBuffer {
+public:
+    explicit MetricsBuffer(string &target) : out(target) {}
+
+    MetricsBuffer &append(string_view text) {
+        out.append(text.data(), text.size());
+        return *this;
+    }
+
+    MetricsBuffer &append(char ch) {
+        out.push_back(ch);
+        return *this;
+    }
+
+    MetricsBuffer &append(uint64_t value) {
+        char digits[24];
+        auto result = to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+        return *this;
+    }
+
+    MetricsBuffer &append(int64_t value) {
+        char digits[24];
+        auto result = to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+        return *this;
+    }
+
+    MetricsBuffer &append(double value) {
+        if (!std::isfinite(value)) {
+            value = 0.0;
+        }
+        char digits[32];
+        auto result = to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+        return *this;
+    }
+
+    MetricsBuffer &appendJsonString(string_view text) {
+        out.push_back('"');
+        for (char ch : text) {
+            if (ch == '"' || ch == '\\') {
+                out.push_back('\\');
+                out.push_back(ch);
+            } else if (static_cast<unsigned char>(ch) < 0x20) {
+                static const char hex[] = "0123456789abcdef";
+                out.append("\\u00");
+                out.push_back(hex[(ch >> 4) & 0xF]);
+                out.push_back(hex[ch & 0xF]);
+            } else {
+                out.push_back(ch);
+            }
+        }
+        out.push_back('"');
+        return *this;
+    }
+
+private:
+    string &out;
+};
+
+inline const char *difficultyLabel(Difficulty difficulty) {
+    switch (difficulty) {
+    case Difficulty::EASY:
+        return "Easy";
+    case Difficulty::MEDIUM:
+        return "Medium";
+    case Difficulty::HARD:
+        return "Hard";
+    }
+    return "Easy";
+}
+
+// Formats leaderboard rows into one buffer with the same left-aligned column
+// layout displayLeaderboard() has always printed, without iostream manipulators.
+class LeaderboardRenderer {
+public:
+    static constexpr size_t kRankWidth = 5;
+    static constexpr size_t kNameWidth = 15;
+    static constexpr size_t kScoreWidth = 10;
+    static constexpr size_t kGamesWidth = 10;
+    static constexpr size_t kAttemptsWidth = 12;
+    static constexpr size_t kTimeWidth = 12;
+    static constexpr size_t kAccuracyWidth = 12;
+    static constexpr size_t kGuessWidth = 15;
+    static constexpr size_t kDifficultyWidth = 12;
+    static constexpr size_t kRowEstimate = 110;
+
+    static void appendHeader(string &out) {
+        appendColumn(out, "Rank", kRankWidth);
+        appendColumn(out, "Name", kNameWidth);
+        appendColumn(out, "Score", kScoreWidth);
+        appendColumn(out, "Games", kGamesWidth);
+        appendColumn(out, "Attempts", kAttemptsWidth);
+        appendColumn(out, "Avg Time", kTimeWidth);
+        appendColumn(out, "Accuracy", kAccuracyWidth);
+        appendColumn(out, "Avg Guess", kGuessWidth);
+        appendColumn(out, "Difficulty", kDifficultyWidth);
+        out.push_back('\n');
+    }
+
+    static void appendRow(string &out, const LeaderboardEntry &entry, size_t rank) {
+        char number[64] = {};
+        appendColumn(out, formatInteger(number, rank), kRankWidth);
+        appendColumn(out, entry.name, kNameWidth);
+        appendColumn(out, formatInteger(number, entry.score), kScoreWidth);
+        appendColumn(out, formatInteger(number, entry.games), kGamesWidth);
+        appendColumn(out, formatInteger(number, entry.attempts), kAttemptsWidth);
+        appendColumn(out, formatFixed(number, entry.averageTime, 1), kTimeWidth);
+        appendColumn(out, formatFixed(number, entry.accuracy, 1), kAccuracyWidth);
+        out.push_back('%');
+        appendColumn(out, formatFixed(number, entry.averageGuessTime, 2), kGuessWidth);
+        appendColumn(out, difficultyLabel(entry.difficulty), kDifficultyWidth);
+        out.push_back('\n');
+    }
+
+private:
+    static void appendColumn(string &out, string_view text, size_t width) {
+        out.append(text.data(), text.size());
+        if (text.size() < width) {
+            out.append(width - text.size(), ' ');
+        }
+    }
+
+    template <typename Integer>
+    static string_view formatInteger(char (&buffer)[64], Integer value) {
+        auto result = to_chars(buffer, buffer + sizeof(buffer), value);
+        return string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+
+    static string_view formatFixed(char (&buffer)[64], double value, int precision) {
+        if (!std::isfinite(value)) {
+            return std::isnan(value) ? "nan" : value > 0 ? "inf" : "-inf";
+        }
+        auto result = to_chars(buffer, buffer + sizeof(buffer), value, chars_format::fixed, precision);
+        if (result.ec != errc()) {
+            int length = snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+            return string_view(buffer, static_cast<size_t>(max(length, 0)));
+        }
+        return string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+};
+
+constexpr size_t kMallocOverhead = 16;
+
+// Heap bytes a string owns beyond its inline (SSO) buffer, plus malloc's chunk header.
+inline size_t stringHeapBytes(const string &value) {
+    static const size_t inlineCapacity = string().capacity();
+    return value.capacity() > inlineCapacity ? value.capacity() + 1 + kMallocOverhead : 0;
+}
+
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+struct MaskedMoments {
+    size_t count{0};
+    double sum{0.0};
+    double min{0.0};
+    double max{0.0};
+};
+
+// Masked count/sum/min/max over one leaderboard column, keeping rows whose
+// difficulty byte equals `level` (0 keeps every row) and whose value is not
+// NaN; min/max would otherwise depend on which lane met the NaN. One entry point picks
+// AVX2, SSE2 or plain C++ from what the running CPU supports, so the same
+// binary is fast on new machines and still correct on old ones. Counts, min
+// and max agree exactly across kernels; sums can differ in the last bits since
+// the lanes add in a different order.
+class ColumnKernels {
+public:
+    static SimdLevel detectedLevel() {
+        static const SimdLevel level = detect();
+        return level;
+    }
+
+    // Clamps a requested kernel to what the CPU can actually run.
+    static SimdLevel usableLevel(SimdLevel requested) {
+        return static_cast<int>(requested) <= static_cast<int>(detectedLevel()) ? requested : detectedLevel();
+    }
+
+    static const char *levelName(SimdLevel level) {
+        switch (level) {
+        case SimdLevel::SCALAR:
+            return "scalar";
+        case SimdLevel::SSE2:
+            return "sse2";
+        case SimdLevel::AVX2:
+            return "avx2";
+        }
+        return "scalar";
+    }
+
+    template <typename T>
+    static MaskedMoments moments(const T *values, const uint8_t *levels, size_t rows, uint8_t level,
+                                 SimdLevel simd = detectedLevel()) {
+        switch (usableLevel(simd)) {
+#if defined(WORDSCRAMBLE_HAS_X86_DISPATCH)
+        case SimdLevel::AVX2:
+            return avx2Moments(values, levels, rows, level);
+        case SimdLevel::SSE2:
+            return sse2Moments(values, levels, rows, level);
+#endif
+        default:
+            return scalarMoments(values, levels, rows, level);
+        }
+    }
+
+private:
+    static SimdLevel detect() {
+#if defined(WORDSCRAMBLE_HAS_X86_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return SimdLevel::SSE2;
+        }
+#endif
+        return SimdLevel::SCALAR;
+    }
+
+    // Folds rows [start, rows) into `result` one at a time; shared tail for every kernel.
+    template <typename T>
+    static void finishScalar(MaskedMoments &result, const T *values, const uint8_t *levels, size_t start, size_t rows,
+                             uint8_t level) {
+        for (size_t i = start; i < rows; ++i) {
+            double value = static_cast<double>(values[i]);
+            if ((level != 0 && levels[i] != level) || value != value) {
+                continue;
+            }
+            result.min = result.count == 0 ? value : min(result.min, value);
+            result.max = result.count == 0 ? value : max(result.max, value);
+            result.sum += value;
+            result.count++;
+        }
+    }
+
+    // Branch-free: rows that do not match fold in as 0 / +inf / -inf via bit masks
+    // (GCC turns a plain ?: over loaded doubles into a jump).
+    template <typename T>
+    static MaskedMoments scalarMoments(const T *values, const uint8_t *levels, size_t rows, uint8_t level) {
+        bool matchAll = level == 0;
+        size_t count = 0;
+        double sum = 0.0;
+        double low = HUGE_VAL;
+        double high = -HUGE_VAL;
+        for (size_t i = 0; i < rows; ++i) {
+            double value = static_cast<double>(values[i]);
+            bool take = (matchAll | (levels[i] == level)) & (value == value);
+            count += take;
+            sum += pick(value, 0.0, take);
+            low = min(low, pick(value, HUGE_VAL, take));
+            high = max(high, pick(value, -HUGE_VAL, take));
+        }
+        MaskedMoments result;
+        mergeLanes(result, count, sum, &low, &high, 1);
+        return result;
+    }
+
+    static double pick(double yes, double no, bool take) {
+        uint64_t yesBits;
+        uint64_t noBits;
+        memcpy(&yesBits, &yes, sizeof(yesBits));
+        memcpy(&noBits, &no, sizeof(noBits));
+        uint64_t mask = 0 - static_cast<uint64_t>(take);
+        uint64_t bits = (yesBits & mask) | (noBits & ~mask);
+        double picked;
+        memcpy(&picked, &bits, sizeof(picked));
+        return picked;
+    }
+
+    // Merges per-lane partials; lanes that saw no rows hold +/-infinity and drop out.
+    static void mergeLanes(MaskedMoments &result, size_t count, double sum, const double *lows, const double *highs,
+                           size_t lanes) {
+        result.count = count;
+        result.sum = sum;
+        if (count == 0) {
+            return;
+        }
+        result.min = lows[0];
+        result.max = highs[0];
+        for (size_t lane = 1; lane < lanes; ++lane) {
+            result.min = min(result.min, lows[lane]);
+            result.max = max(result.max, highs[lane]);
+        }
+    }
+
+#if defined(WORDSCRAMBLE_HAS_X86_DISPATCH)
+    __attribute__((target("avx2"))) static __m256d avx2Load(const double *values) {
+        return _mm256_loadu_pd(values);
+    }
+
+    __attribute__((target("avx2"))) static __m256d avx2Load(const int32_t *values) {
+        return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values)));
+    }
+
+    // All-ones lanes where the four level bytes at `levels` match.
+    __attribute__((target("avx2"))) static __m256d avx2Mask(const uint8_t *levels, __m256i want, __m256i everything) {
+        int32_t packed;
+        memcpy(&packed, levels, sizeof(packed));
+        __m256i widened = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(packed));
+        return _mm256_castsi256_pd(_mm256_or_si256(_mm256_cmpeq_epi64(widened, want), everything));
+    }
+
+    template <typename T>
+    __attribute__((target("avx2"))) static MaskedMoments avx2Moments(const T *values, const uint8_t *levels, size_t rows,
+                                                                      uint8_t level) {
+        const __m256i want = _mm256_set1_epi64x(level);
+        const __m256i everything = level == 0 ? _mm256_set1_epi64x(-1) : _mm256_setzero_si256();
+        const __m256d positive = _mm256_set1_pd(HUGE_VAL);
+        const __m256d negative = _mm256_set1_pd(-HUGE_VAL);
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        __m256d low0 = positive;
+        __m256d low1 = positive;
+        __m256d high0 = negative;
+        __m256d high1 = negative;
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 8 <= rows; i += 8) {
+            __m256d value0 = avx2Load(values + i);
+            __m256d value1 = avx2Load(values + i + 4);
+            __m256d mask0 = _mm256_and_pd(avx2Mask(levels + i, want, everything), _mm256_cmp_pd(value0, value0, _CMP_ORD_Q));
+            __m256d mask1 = _mm256_and_pd(avx2Mask(levels + i + 4, want, everything), _mm256_cmp_pd(value1, value1, _CMP_ORD_Q));
+            sum0 = _mm256_add_pd(sum0, _mm256_and_pd(value0, mask0));
+            sum1 = _mm256_add_pd(sum1, _mm256_and_pd(value1, mask1));
+            low0 = _mm256_min_pd(low0, _mm256_blendv_pd(positive, value0, mask0));
+            low1 = _mm256_min_pd(low1, _mm256_blendv_pd(positive, value1, mask1));
+            high0 = _mm256_max_pd(high0, _mm256_blendv_pd(negative, value0, mask0));
+            high1 = _mm256_max_pd(high1, _mm256_blendv_pd(negative, value1, mask1));
+            count += popCount(static_cast<uint64_t>(_mm256_movemask_pd(mask0) | (_mm256_movemask_pd(mask1) << 4)));
+        }
+        alignas(32) double sums[4];
+        alignas(32) double lows[4];
+        alignas(32) double highs[4];
+        _mm256_store_pd(sums, _mm256_add_pd(sum0, sum1));
+        _mm256_store_pd(lows, _mm256_min_pd(low0, low1));
+        _mm256_store_pd(highs, _mm256_max_pd(high0, high1));
+        MaskedMoments result;
+        mergeLanes(result, count, (sums[0] + sums[1]) + (sums[2] + sums[3]), lows, highs, 4);
+        finishScalar(result, values, levels, i, rows, level);
+        return result;
+    }
+
+    __attribute__((target("sse2"))) static __m128d sse2Load(const double *values) {
+        return _mm_loadu_pd(values);
+    }
+
+    __attribute__((target("sse2"))) static __m128d sse2Load(const int32_t *values) {
+        return _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(values)));
+    }
+
+    template <typename T>
+    __attribute__((target("sse2"))) static MaskedMoments sse2Moments(const T *values, const uint8_t *levels, size_t rows,
+                                                                      uint8_t level) {
+        const __m128d want = _mm_set1_pd(level);
+        const __m128d everything = level == 0 ? _mm_castsi128_pd(_mm_set1_epi64x(-1)) : _mm_setzero_pd();
+        const __m128d positive = _mm_set1_pd(HUGE_VAL);
+        const __m128d negative = _mm_set1_pd(-HUGE_VAL);
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        __m128d low = positive;
+        __m128d high = negative;
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 4 <= rows; i += 4) {
+            __m128d value0 = sse2Load(values + i);
+            __m128d value1 = sse2Load(values + i + 2);
+            __m128d mask0 = _mm_or_pd(_mm_cmpeq_pd(_mm_set_pd(levels[i + 1], levels[i]), want), everything);
+            __m128d mask1 = _mm_or_pd(_mm_cmpeq_pd(_mm_set_pd(levels[i + 3], levels[i + 2]), want), everything);
+            mask0 = _mm_and_pd(mask0, _mm_cmpord_pd(value0, value0));
+            mask1 = _mm_and_pd(mask1, _mm_cmpord_pd(value1, value1));
+            sum0 = _mm_add_pd(sum0, _mm_and_pd(value0, mask0));
+            sum1 = _mm_add_pd(sum1, _mm_and_pd(value1, mask1));
+            low = _mm_min_pd(low, _mm_or_pd(_mm_and_pd(mask0, value0), _mm_andnot_pd(mask0, positive)));
+            low = _mm_min_pd(low, _mm_or_pd(_mm_and_pd(mask1, value1), _mm_andnot_pd(mask1, positive)));
+            high = _mm_max_pd(high, _mm_or_pd(_mm_and_pd(mask0, value0), _mm_andnot_pd(mask0, negative)));
+            high = _mm_max_pd(high, _mm_or_pd(_mm_and_pd(mask1, value1), _mm_andnot_pd(mask1, negative)));
+            count += popCount(static_cast<uint64_t>(_mm_movemask_pd(mask0) | (_mm_movemask_pd(mask1) << 2)));
+        }
+        double sums[2];
+        double lows[2];
+        double highs[2];
+        _mm_storeu_pd(sums, _mm_add_pd(sum0, sum1));
+        _mm_storeu_pd(lows, low);
+        _mm_storeu_pd(highs, high);
+        MaskedMoments result;
+        mergeLanes(result, count, sums[0] + sums[1], lows, highs, 2);
+        finishScalar(result, values, levels, i, rows, level);
+        return result;
+    }
+#endif
+};
+
+struct ColumnSummary {
+    size_t count{0};
+    double mean{0.0};
+    double min{0.0};
+    double max{0.0};
+    double p50{0.0};
+    double p90{0.0};
+    double p99{0.0};
+};
+
+struct LeaderboardStatistics {
+    ColumnSummary score;
+    ColumnSummary accuracy;
+    ColumnSummary averageGuessTime;
+};
+
+struct LeaderboardAggregate {
+    size_t count{0};
+    int minScore{0};
+    int maxScore{0};
+    double meanScore{0.0};
+    double meanAccuracy{0.0};
+    double meanAverageTime{0.0};
+    double meanGuessTime{0.0};
+};
+
+// Bucket i counts scores in [lowestScore + i * bucketWidth, + bucketWidth).
+// bucketWidth may be wider than requested: it grows so that at most
+// kMaxScoreBuckets buckets cover the score range.
+constexpr size_t kMaxScoreBuckets = 4096;
+
+struct ScoreHistogram {
+    int lowestScore{0};
+    int bucketWidth{1};
+    vector<size_t> counts;
+};
+
+// Struct-of-arrays copy of the leaderboard for analytic scans. Each numeric
+// field is its own contiguous column and names sit in one string table, so a
+// pass over accuracy streams 8 bytes per row instead of whole entries with a
+// std::string in the middle. Rows are indexed like LeaderboardStore slots.
+class LeaderboardColumns {
+public:
+    size_t size() const {
+        return scores.size();
+    }
+
+    void clear() {
+        scores.clear();
+        games.clear();
+        attempts.clear();
+        accuracy.clear();
+        averageTime.clear();
+        averageGuessTime.clear();
+        difficulty.clear();
+        playedAt.clear();
+        names.clear();
+        nameOffsets.assign(1, 0);
+    }
+
+    void reserve(size_t rows) {
+        scores.reserve(rows);
+        games.reserve(rows);
+        attempts.reserve(rows);
+        accuracy.reserve(rows);
+        averageTime.reserve(rows);
+        averageGuessTime.reserve(rows);
+        difficulty.reserve(rows);
+        playedAt.reserve(rows);
+        nameOffsets.reserve(rows + 1);
+    }
+
+    void append(const LeaderboardEntry &entry) {
+        scores.push_back(entry.score);
+        games.push_back(entry.games);
+        attempts.push_back(entry.attempts);
+        accuracy.push_back(entry.accuracy);
+        averageTime.push_back(entry.averageTime);
+        averageGuessTime.push_back(entry.averageGuessTime);
+        difficulty.push_back(static_cast<uint8_t>(entry.difficulty));
+        playedAt.push_back(entry.playedAt);
+        names.append(entry.name);
+        nameOffsets.push_back(names.size());
+    }
+
+    // Numeric fields only: a row keeps its name for life (upserts are keyed by name).
+    void update(size_t row, const LeaderboardEntry &entry) {
+        scores[row] = entry.score;
+        games[row] = entry.games;
+        attempts[row] = entry.attempts;
+        accuracy[row] = entry.accuracy;
+        averageTime[row] = entry.averageTime;
+        averageGuessTime[row] = entry.averageGuessTime;
+        difficulty[row] = static_cast<uint8_t>(entry.difficulty);
+        playedAt[row] = entry.playedAt;
+    }
+
+    string_view nameAt(size_t row) const {
+        return string_view(names.data() + nameOffsets[row], nameOffsets[row + 1] - nameOffsets[row]);
+    }
+
+    const vector<int32_t> &scoreColumn() const {
+        return scores;
+    }
+
+    const vector<double> &accuracyColumn() const {
+        return accuracy;
+    }
+
+    const vector<double> &guessTimeColumn() const {
+        return averageGuessTime;
+    }
+
+    const vector<uint8_t> &difficultyColumn() const {
+        return difficulty;
+    }
+
+    LeaderboardAggregate aggregate() const {
+        return aggregateMatching(0);
+    }
+
+    LeaderboardAggregate aggregate(Difficulty level) const {
+        return aggregateMatching(static_cast<uint8_t>(level));
+    }
+
+    // Mean, min, max and p50/p90/p99 of score, accuracy and average guess time.
+    LeaderboardStatistics statistics(SimdLevel simd = ColumnKernels::detectedLevel()) const {
+        return statisticsMatching(0, simd);
+    }
+
+    LeaderboardStatistics statistics(Difficulty level, SimdLevel simd = ColumnKernels::detectedLevel()) const {
+        return statisticsMatching(static_cast<uint8_t>(level), simd);
+    }
+
+    ScoreHistogram scoreHistogram(int bucketWidth) const {
+        ScoreHistogram histogram;
+        histogram.bucketWidth = max(bucketWidth, 1);
+        if (scores.empty()) {
+            return histogram;
+        }
+        auto bounds = minmax_element(scores.begin(), scores.end());
+        histogram.lowestScore = *bounds.first;
+        int64_t span = static_cast<int64_t>(*bounds.second) - *bounds.first;
+        int64_t widest = span / static_cast<int64_t>(kMaxScoreBuckets) + 1;
+        histogram.bucketWidth = static_cast<int>(max<int64_t>(histogram.bucketWidth, widest));
+        histogram.counts.assign(static_cast<size_t>(span / histogram.bucketWidth) + 1, 0);
+        for (int32_t score : scores) {
+            histogram.counts[static_cast<size_t>((static_cast<int64_t>(score) - histogram.lowestScore) / histogram.bucketWidth)]++;
+        }
+        return histogram;
+    }
+
+    size_t memoryBytes() const {
+        return (scores.capacity() + games.capacity() + attempts.capacity()) * sizeof(int32_t)
+               + (accuracy.capacity() + averageTime.capacity() + averageGuessTime.capacity()) * sizeof(double)
+               + difficulty.capacity() + playedAt.capacity() * sizeof(int64_t) + names.capacity()
+               + nameOffsets.capacity() * sizeof(size_t);
+    }
+
+private:
+    // level 0 matches every row.
+    LeaderboardAggregate aggregateMatching(uint8_t level) const {
+        LeaderboardAggregate result;
+        const uint8_t *levels = difficulty.data();
+        size_t rows = scores.size();
+        MaskedMoments score = ColumnKernels::moments(scores.data(), levels, rows, level);
+        if (score.count == 0) {
+            return result;
+        }
+        double count = static_cast<double>(score.count);
+        result.count = score.count;
+        result.minScore = static_cast<int>(score.min);
+        result.maxScore = static_cast<int>(score.max);
+        result.meanScore = score.sum / count;
+        result.meanAccuracy = ColumnKernels::moments(accuracy.data(), levels, rows, level).sum / count;
+        result.meanAverageTime = ColumnKernels::moments(averageTime.data(), levels, rows, level).sum / count;
+        result.meanGuessTime = ColumnKernels::moments(averageGuessTime.data(), levels, rows, level).sum / count;
+        return result;
+    }
+
+    // Moments come from the SIMD kernels; percentiles (nearest rank) from
+    // nth_element over the matching values copied into `scratch`. NaN is left
+    // out of both, as it has no place in the ordering nth_element relies on.
+    template <typename T>
+    ColumnSummary summarize(const T *values, uint8_t level, SimdLevel simd, vector<double> &scratch) const {
+        ColumnSummary summary;
+        MaskedMoments moments = ColumnKernels::moments(values, difficulty.data(), scores.size(), level, simd);
+        if (moments.count == 0) {
+            return summary;
+        }
+        summary.count = moments.count;
+        summary.mean = moments.sum / static_cast<double>(moments.count);
+        summary.min = moments.min;
+        summary.max = moments.max;
+        scratch.resize(scores.size());
+        size_t kept = 0;
+        for (size_t i = 0; i < scores.size(); ++i) {
+            double value = static_cast<double>(values[i]);
+            scratch[kept] = value;
+            kept += (level == 0 || difficulty[i] == level) && value == value;
+        }
+        scratch.resize(kept);
+        auto begin = scratch.begin();
+        auto select = [&](double fraction) {
+            size_t rank = static_cast<size_t>(ceil(fraction * static_cast<double>(kept)));
+            auto target = scratch.begin() + static_cast<ptrdiff_t>(rank == 0 ? 0 : rank - 1);
+            nth_element(begin, target, scratch.end());
+            begin = target;
+            return *target;
+        };
+        summary.p50 = select(0.50);
+        summary.p90 = select(0.90);
+        summary.p99 = select(0.99);
+        return summary;
+    }
+
+    LeaderboardStatistics statisticsMatching(uint8_t level, SimdLevel simd) const {
+        LeaderboardStatistics statistics;
+        vector<double> scratch;
+        statistics.score = summarize(scores.data(), level, simd, scratch);
+        statistics.accuracy = summarize(accuracy.data(), level, simd, scratch);
+        statistics.averageGuessTime = summarize(averageGuessTime.data(), level, simd, scratch);
+        return statistics;
+    }
+
+    vector<int32_t> scores;
+    vector<int32_t> games;
+    vector<int32_t> attempts;
+    vector<double> accuracy;
+    vector<double> averageTime;
+    vector<double> averageGuessTime;
+    vector<uint8_t> difficulty;
+    vector<int64_t> playedAt;
+    string names;
+    vector<size_t> nameOffsets{0};
+};
+
+// Below this many elements a single std::sort beats spawning workers.
+constexpr size_t kParallelSortThreshold = size_t(1) << 17;
+
+inline size_t defaultSortThreads() {
+    return max<size_t>(1, thread::hardware_concurrency());
+}
+
+// std::sort split across `workers` threads: each sorts a contiguous chunk, then
+// runs are merged pairwise, each round's merges in parallel, through one
+// scratch buffer. For a strict total order the result is identical to
+// std::sort; below the threshold it simply is std::sort.
+template <typename T, typename Compare>
+void parallelSort(vector<T> &values, Compare compare, size_t workers) {
+    workers = min(workers, values.size() / (kParallelSortThreshold / 2));
+    if (workers <= 1 || values.size() < kParallelSortThreshold) {
+        sort(values.begin(), values.end(), compare);
+        return;
+    }
+    vector<size_t> bounds(workers + 1);
+    for (size_t i = 0; i <= workers; ++i) {
+        bounds[i] = values.size() * i / workers;
+    }
+    auto at = [](vector<T> &run, size_t index) {
+        return run.begin() + static_cast<ptrdiff_t>(index);
+    };
+    vector<thread> pool;
+    for (size_t i = 1; i < workers; ++i) {
+        pool.emplace_back([&, i] {
+            sort(at(values, bounds[i]), at(values, bounds[i + 1]), compare);
+        });
+    }
+    sort(at(values, bounds[0]), at(values, bounds[1]), compare);
+    for (auto &worker : pool) {
+        worker.join();
+    }
+    vector<T> scratch(values.size());
+    while (bounds.size() > 2) {
+        vector<size_t> merged;
+        pool.clear();
+        for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+            if (i + 2 >= bounds.size()) {
+                copy(at(values, bounds[i]), at(values, bounds[i + 1]), at(scratch, bounds[i]));
+                continue;
+            }
+            pool.emplace_back([&, i] {
+                merge(at(values, bounds[i]), at(values, bounds[i + 1]), at(values, bounds[i + 1]), at(values, bounds[i + 2]),
+                      at(scratch, bounds[i]), compare);
+            });
+        }
+        merged.push_back(values.size());
+        for (auto &worker : pool) {
+            worker.join();
+        }
+        values.swap(scratch);
+        bounds.swap(merged);
+    }
+}
+
+// Stable ascending LSD radix sort by a 64-bit key, one byte per pass. Sorts
+// (key, index) pairs and permutes `values` once at the end, so wide records
+// move a single time; a byte that is equal in every key costs no pass.
+template <typename T, typename KeyOf>
+void radixSortByKey(vector<T> &values, KeyOf keyOf) {
+    struct Keyed {
+        uint64_t key;
+        uint32_t index;
+    };
+    size_t count = values.size();
+    if (count < 2) {
+        return;
+    }
+    vector<Keyed> keyed(count);
+    vector<Keyed> scratch(count);
+    vector<array<size_t, 256>> histograms(8);
+    for (auto &histogram : histograms) {
+        histogram.fill(0);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = keyOf(values[i]);
+        keyed[i] = Keyed{key, static_cast<uint32_t>(i)};
+        for (unsigned pass = 0; pass < 8; ++pass) {
+            ++histograms[pass][(key >> (pass * 8)) & 0xFF];
+        }
+    }
+    for (unsigned pass = 0; pass < 8; ++pass) {
+        array<size_t, 256> &offsets = histograms[pass];
+        unsigned shift = pass * 8;
+        if (offsets[(keyed[0].key >> shift) & 0xFF] == count) {
+            continue;
+        }
+        size_t total = 0;
+        for (size_t &offset : offsets) {
+            size_t bucket = offset;
+            offset = total;
+            total += bucket;
+        }
+        for (const Keyed &item : keyed) {
+            scratch[offsets[(item.key >> shift) & 0xFF]++] = item;
+        }
+        keyed.swap(scratch);
+    }
+    vector<T> sorted;
+    sorted.reserve(count);
+    for (const Keyed &item : keyed) {
+        sorted.push_back(std::move(values[item.index]));
+    }
+    values.swap(sorted);
+}
+
+// Higher accuracy ranks first and NaN ranks after every number, so the
+// leaderboard comparators stay strict weak orders whatever the data holds.
+inline bool accuracyRanksAbove(double lhs, double rhs) {
+    return !std::isnan(lhs) && (std::isnan(rhs) || lhs > rhs);
+}
+
+// The ranking fields copied next to the slot id, so bulk sorts compare
+// contiguous 16-byte records instead of chasing slots into entries.
+struct RankKey {
+    double accuracy;
+    int32_t score;
+    uint32_t slot;
+};
+
+// Score desc, accuracy desc, slot asc: the leaderboard order.
+struct RankKeyOrder {
+    bool operator()(const RankKey &lhs, const RankKey &rhs) const {
+        if (lhs.score != rhs.score) {
+            return lhs.score > rhs.score;
+        }
+        if (accuracyRanksAbove(lhs.accuracy, rhs.accuracy)) {
+            return true;
+        }
+        if (accuracyRanksAbove(rhs.accuracy, lhs.accuracy)) {
+            return false;
+        }
+        return lhs.slot < rhs.slot;
+    }
+};
+
+// Ascending in this key means descending by score, then by the top 32 bits of
+// accuracy. Doubles map to integers by flipping the sign bit of positives and
+// every bit of negatives; -0.0 is folded into 0.0 first since they compare equal,
+// and NaN shares the key of -inf so the tie fix-up puts it last.
+inline uint64_t packedRankKey(const RankKey &key) {
+    uint64_t bits;
+    double accuracy = std::isnan(key.accuracy) ? -numeric_limits<double>::infinity() : key.accuracy + 0.0;
+    memcpy(&bits, &accuracy, sizeof(bits));
+    bits ^= (uint64_t(0) - (bits >> 63)) | (uint64_t(1) << 63);
+    uint64_t score = static_cast<uint32_t>(key.score) ^ 0x80000000u;
+    return ~((score << 32) | (bits >> 32));
+}
+
+// AUTO splits large views across workers when there is more than one and
+// radix-sorts everything else.
+enum class SortAlgorithm {
+    AUTO,
+    COMPARISON,
+    RADIX
+};
+
+// Below this the eight histogram passes cost more than std::sort saves.
+constexpr size_t kRadixSortThreshold = 2048;
+
+// Leaderboard order in O(n): radix sort on packedRankKey, then the rows whose
+// packed keys tie (same score, accuracy equal to 32 bits) are finished with
+// RankKeyOrder. The sort is stable, so tie runs from slot-ordered input are
+// already in order and only get checked; the result matches std::sort exactly.
+inline void radixSortRankKeys(vector<RankKey> &keys) {
+    if (keys.size() < kRadixSortThreshold) {
+        sort(keys.begin(), keys.end(), RankKeyOrder());
+        return;
+    }
+    radixSortByKey(keys, packedRankKey);
+    for (size_t begin = 0; begin < keys.size();) {
+        uint64_t packed = packedRankKey(keys[begin]);
+        size_t end = begin + 1;
+        while (end < keys.size() && packedRankKey(keys[end]) == packed) {
+            ++end;
+        }
+        auto first = keys.begin() + static_cast<ptrdiff_t>(begin);
+        auto last = keys.begin() + static_cast<ptrdiff_t>(end);
+        if (end - begin > 1 && !is_sorted(first, last, RankKeyOrder())) {
+            sort(first, last, RankKeyOrder());
+        }
+        begin = end;
+    }
+}
+
+// Entries live in stable slots shared by several ranked views: the global view
+// ranks every row and one view per Difficulty ranks only that level. A view is
+// a vector of slot ids ordered by score desc, accuracy desc, then slot, so every
+// entry has one exact position a binary search can find, plus a name -> best
+// slot index. Ranks are positional rather than stored, which keeps an insert to
+// one upper_bound and a 4-byte-per-row shift per view instead of a re-sort.
+//
+// Daily and weekly boards are two-bucket rings of views keyed to the calendar:
+// the newest period seen and the one before it. A row from a newer period rolls
+// the ring forward by recycling the buckets that fall out of it, so expiry never
+// scans or re-sorts surviving rows. A bucket that upserts drain stays empty.
+class LeaderboardStore {
+public:
+    struct RankedView {
+        vector<uint32_t> slots;
+        unordered_map<string, uint32_t> best;
+    };
+
+    static constexpr size_t kGlobalView = 0;
+    static constexpr size_t kViewCount = 4;
+    static constexpr int64_t kSecondsPerDay = 86400;
+    // 1970-01-01 was a Thursday; weekly periods start on Monday.
+    static constexpr int64_t kWeekOrigin = -3 * kSecondsPerDay;
+
+    // Unknown levels rank with EASY, matching how the loader and renderer treat them.
+    static size_t viewFor(Difficulty difficulty) {
+        int level = static_cast<int>(difficulty);
+        return level >= 1 && level < static_cast<int>(kViewCount) ? static_cast<size_t>(level) : 1;
+    }
+
+    // Ranking order without the slot tie-break.
+    static bool outranks(const LeaderboardEntry &lhs, const LeaderboardEntry &rhs) {
+        if (lhs.score != rhs.score) {
+            return lhs.score > rhs.score;
+        }
+        return accuracyRanksAbove(lhs.accuracy, rhs.accuracy);
+    }
+
+    // Period number containing `playedAt`; rows without a timestamp (<= 0) belong to none.
+    static int64_t periodOf(LeaderboardWindow window, int64_t playedAt) {
+        if (playedAt <= 0) {
+            return kNoPeriod;
+        }
+        if (window == LeaderboardWindow::DAILY) {
+            return playedAt / kSecondsPerDay;
+        }
+        return (playedAt - kWeekOrigin) / (7 * kSecondsPerDay);
+    }
+
+    const RankedView &view(size_t index) const {
+        return views[index];
+    }
+
+    // The daily or weekly view for the period containing `at`; empty once that period has rolled off.
+    const RankedView &windowView(LeaderboardWindow window, int64_t at) const {
+        const TimeWindow &ring = windows[static_cast<size_t>(window)];
+        int64_t period = periodOf(window, at);
+        for (size_t i = 0; i < ring.periods.size(); ++i) {
+            if (period != kNoPeriod && ring.periods[i] == period) {
+                return ring.views[i];
+            }
+        }
+        static const RankedView empty;
+        return empty;
+    }
+
+    size_t size() const {
+        return views[kGlobalView].slots.size();
+    }
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+    uint32_t insert(LeaderboardEntry entry) {
+        uint32_t slot = static_cast<uint32_t>(entries.size());
+        entry.rank = 0;
+        nameBytes += stringHeapBytes(entry.name);
+        entries.push_back(std::move(entry));
+        columns.append(entries[slot]);
+        link(views[kGlobalView], slot);
+        link(views[viewFor(entries[slot].difficulty)], slot);
+        linkWindows(slot);
+        return slot;
+    }
+
+    // Replaces the player's row (always for KEEP_LATEST, only when outranked for
+    // KEEP_BEST) and slides it to its new position in each view; appends when
+    // the name is new. Assumes one row per player, see collapseByName(). KEEP_BEST
+    // games have the windows switched off, so their rings are not touched here.
+    uint32_t upsert(LeaderboardEntry entry, bool keepLatest) {
+        auto found = views[kGlobalView].best.find(entry.name);
+        if (found == views[kGlobalView].best.end()) {
+            return insert(std::move(entry));
+        }
+        uint32_t slot = found->second;
+        LeaderboardEntry &current = entries[slot];
+        if (!keepLatest && !outranks(entry, current)) {
+            return slot;
+        }
+        RankedView &oldLevel = views[viewFor(current.difficulty)];
+        RankedView &newLevel = views[viewFor(entry.difficulty)];
+        size_t globalIndex = locate(views[kGlobalView], slot);
+        size_t levelIndex = locate(oldLevel, slot);
+        if (&oldLevel != &newLevel && levelIndex < oldLevel.slots.size()) {
+            unlink(oldLevel, levelIndex);
+        }
+        unlinkWindows(slot);
+        nameBytes -= stringHeapBytes(current.name);
+        entry.rank = 0;
+        current = std::move(entry);
+        nameBytes += stringHeapBytes(current.name);
+        columns.update(slot, current);
+        relink(views[kGlobalView], globalIndex, slot);
+        if (&oldLevel != &newLevel) {
+            link(newLevel, slot);
+        } else {
+            relink(oldLevel, levelIndex, slot);
+        }
+        linkWindows(slot);
+        return slot;
+    }
+
+    // Drops all but one row per player, preserving slot order so ties keep their
+    // relative order. O(n). The latest row is the one with the greatest playedAt;
+    // slots only break ties, since after a load they follow rank, not time.
+    void collapseByName(bool keepLatest) {
+        unordered_map<string, uint32_t> &keep = views[kGlobalView].best;
+        if (keep.size() == entries.size()) {
+            return;
+        }
+        if (keepLatest) {
+            keep.clear();
+            for (uint32_t slot = 0; slot < entries.size(); ++slot) {
+                auto inserted = keep.try_emplace(entries[slot].name, slot);
+                if (!inserted.second && entries[slot].playedAt >= entries[inserted.first->second].playedAt) {
+                    inserted.first->second = slot;
+                }
+            }
+        }
+        vector<uint32_t> remap(entries.size(), kDropped);
+        vector<LeaderboardEntry> kept;
+        kept.reserve(keep.size());
+        nameBytes = 0;
+        for (uint32_t slot = 0; slot < entries.size(); ++slot) {
+            if (keep.find(entries[slot].name)->second == slot) {
+                remap[slot] = static_cast<uint32_t>(kept.size());
+                nameBytes += stringHeapBytes(entries[slot].name);
+                kept.push_back(std::move(entries[slot]));
+            }
+        }
+        entries = std::move(kept);
+        rebuildColumns();
+        for (auto &view : views) {
+            size_t out = 0;
+            for (uint32_t slot : view.slots) {
+                if (remap[slot] != kDropped) {
+                    view.slots[out++] = remap[slot];
+                }
+            }
+            view.slots.resize(out);
+            view.slots.shrink_to_fit();
+            view.best.clear();
+            for (uint32_t slot : view.slots) {
+                view.best.emplace(entries[slot].name, slot);
+            }
+        }
+        rebuildWindows();
+    }
+
+    // O(1): the player's best row, or nullptr. Invalidated by the next update.
+    const LeaderboardEntry *find(const string &name) const {
+        auto found = views[kGlobalView].best.find(name);
+        return found == views[kGlobalView].best.end() ? nullptr : &entries[found->second];
+    }
+
+    // Bulk load: one sort per view instead of n binary-search inserts.
+    void assign(vector<LeaderboardEntry> loaded) {
+        entries = std::move(loaded);
+        nameBytes = 0;
+        for (auto &view : views) {
+            view.slots.clear();
+            view.best.clear();
+        }
+        views[kGlobalView].slots.reserve(entries.size());
+        for (uint32_t slot = 0; slot < entries.size(); ++slot) {
+            entries[slot].rank = 0;
+            nameBytes += stringHeapBytes(entries[slot].name);
+            for (size_t view : {kGlobalView, viewFor(entries[slot].difficulty)}) {
+                views[view].slots.push_back(slot);
+                noteBest(views[view], slot);
+            }
+        }
+        for (auto &view : views) {
+            sortView(view);
+        }
+        rebuildColumns();
+        rebuildWindows();
+    }
+
+    // Daily and weekly rings are only kept while enabled; KEEP_BEST turns them off
+    // because it never serves them. Turning them back on rebuilds them from the rows.
+    void setWindowsEnabled(bool enabled) {
+        if (enabled != windowsEnabled) {
+            windowsEnabled = enabled;
+            rebuildWindows();
+        }
+    }
+
+    // 1-based rank of the player's best entry within `view`, 0 if absent. O(log n).
+    size_t rankOf(const string &name, const RankedView &view) const {
+        auto found = view.best.find(name);
+        if (found == view.best.end()) {
+            return 0;
+        }
+        size_t index = locate(view, found->second);
+        return index < view.slots.size() ? index + 1 : 0;
+    }
+
+    size_t rankOf(const string &name) const {
+        return rankOf(name, views[kGlobalView]);
+    }
+
+    // Visits up to `limit` entries of `view` starting at position `offset` as visit(entry, rank).
+    template <typename Visit>
+    void forEachInRange(const RankedView &view, size_t offset, size_t limit, Visit visit) const {
+        size_t begin = min(offset, view.slots.size());
+        size_t end = begin + min(limit, view.slots.size() - begin);
+        for (size_t i = begin; i < end; ++i) {
+            visit(entries[view.slots[i]], i + 1);
+        }
+    }
+
+    // Workers used to sort views on bulk loads; 1 forces the serial path.
+    void setSortThreads(size_t threads) {
+        sortThreads = max<size_t>(1, threads);
+    }
+
+    // RADIX ranks in linear time on one thread; COMPARISON uses parallelSort
+    // across sortThreads; AUTO picks per view.
+    void setSortAlgorithm(SortAlgorithm algorithm) {
+        sortAlgorithm = algorithm;
+    }
+
+    // Columnar mirror of every stored row, for aggregate scans.
+    const LeaderboardColumns &analytics() const {
+        return columns;
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = entries.capacity() * sizeof(LeaderboardEntry) + nameBytes + columns.memoryBytes();
+        for (const auto &view : views) {
+            bytes += viewBytes(view);
+        }
+        for (const auto &ring : windows) {
+            for (const auto &view : ring.views) {
+                bytes += viewBytes(view);
+            }
+        }
+        return bytes;
+    }
+
+private:
+    struct Order {
+        const vector<LeaderboardEntry> *entries;
+
+        bool operator()(uint32_t lhs, uint32_t rhs) const {
+            const LeaderboardEntry &a = (*entries)[lhs];
+            const LeaderboardEntry &b = (*entries)[rhs];
+            if (a.score != b.score) {
+                return a.score > b.score;
+            }
+            if (accuracyRanksAbove(a.accuracy, b.accuracy)) {
+                return true;
+            }
+            if (accuracyRanksAbove(b.accuracy, a.accuracy)) {
+                return false;
+            }
+            return lhs < rhs;
+        }
+    };
+
+    struct TimeWindow {
+        array<int64_t, 2> periods{{kNoPeriod, kNoPeriod}};
+        array<RankedView, 2> views;
+    };
+
+    static constexpr uint32_t kDropped = UINT32_MAX;
+    static constexpr int64_t kNoPeriod = INT64_MIN;
+    static constexpr size_t kWindowCount = 2;
+
+    Order order() const {
+        return Order{&entries};
+    }
+
+    static size_t viewBytes(const RankedView &view) {
+        return view.slots.capacity() * sizeof(uint32_t) + view.best.bucket_count() * sizeof(void *)
+               + view.best.size() * (sizeof(string) + sizeof(uint32_t) + sizeof(size_t) + sizeof(void *) + kMallocOverhead);
+    }
+
+    size_t indexOf(const RankedView &view, uint32_t slot) const {
+        return static_cast<size_t>(lower_bound(view.slots.begin(), view.slots.end(), slot, order()) - view.slots.begin());
+    }
+
+    // indexOf() for a slot known to be in the view. A miss means the view is
+    // out of order: it asserts, and release builds get slots.size().
+    size_t locate(const RankedView &view, uint32_t slot) const {
+        size_t index = indexOf(view, slot);
+        bool found = index < view.slots.size() && view.slots[index] == slot;
+        assert(found && "leaderboard view lost its ordering");
+        return found ? index : view.slots.size();
+    }
+
+    // Re-sorts the slot at `index` after its entry changed, or links it if absent.
+    void relink(RankedView &view, size_t index, uint32_t slot) {
+        if (index < view.slots.size()) {
+            reposition(view, index);
+        } else {
+            link(view, slot);
+        }
+    }
+
+    void link(RankedView &view, uint32_t slot) {
+        view.slots.insert(upper_bound(view.slots.begin(), view.slots.end(), slot, order()), slot);
+        noteBest(view, slot);
+    }
+
+    // Only used with one row per player, so the name leaves the view with its row.
+    void unlink(RankedView &view, size_t index) {
+        view.best.erase(entries[view.slots[index]].name);
+        view.slots.erase(view.slots.begin() + static_cast<ptrdiff_t>(index));
+    }
+
+    void noteBest(RankedView &view, uint32_t slot) {
+        auto inserted = view.best.try_emplace(entries[slot].name, slot);
+        if (!inserted.second && order()(slot, inserted.first->second)) {
+            inserted.first->second = slot;
+        }
+    }
+
+    // Same order as Order, via RankKey records and the configured algorithm.
+    void sortView(RankedView &view) {
+        vector<RankKey> keys(view.slots.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            const LeaderboardEntry &entry = entries[view.slots[i]];
+            keys[i] = RankKey{entry.accuracy, entry.score, view.slots[i]};
+        }
+        SortAlgorithm algorithm = sortAlgorithm;
+        if (algorithm == SortAlgorithm::AUTO) {
+            bool parallel = sortThreads > 1 && keys.size() >= kParallelSortThreshold;
+            algorithm = parallel ? SortAlgorithm::COMPARISON : SortAlgorithm::RADIX;
+        }
+        if (algorithm == SortAlgorithm::RADIX) {
+            radixSortRankKeys(keys);
+        } else {
+            parallelSort(keys, RankKeyOrder(), sortThreads);
+        }
+        for (size_t i = 0; i < keys.size(); ++i) {
+            view.slots[i] = keys[i].slot;
+        }
+    }
+
+    // Moves the slot at `index`, whose entry just changed, to its sorted position.
+    void reposition(RankedView &view, size_t index) {
+        auto position = view.slots.begin() + static_cast<ptrdiff_t>(index);
+        auto target = upper_bound(view.slots.begin(), position, *position, order());
+        if (target != position) {
+            rotate(target, position, position + 1);
+        } else {
+            target = lower_bound(position + 1, view.slots.end(), *position, order());
+            rotate(position, position + 1, target);
+        }
+    }
+
+    // Each ring holds the newest period seen and the one before it. A newer row
+    // rolls the ring forward; rows older than both buckets are ignored.
+    void linkWindows(uint32_t slot) {
+        if (!windowsEnabled) {
+            return;
+        }
+        for (size_t w = 0; w < kWindowCount; ++w) {
+            TimeWindow &ring = windows[w];
+            int64_t period = periodOf(static_cast<LeaderboardWindow>(w), entries[slot].playedAt);
+            if (period == kNoPeriod) {
+                continue;
+            }
+            int64_t latest = max(ring.periods[0], ring.periods[1]);
+            if (period > latest) {
+                rollWindow(ring, period);
+            } else if (period < latest - 1) {
+                continue;
+            }
+            link(ring.views[ring.periods[0] == period ? 0 : 1], slot);
+        }
+    }
+
+    // Points the ring at (latest - 1, latest). A bucket already holding one of
+    // those periods keeps its rows; the others are cleared and relabelled.
+    static void rollWindow(TimeWindow &ring, int64_t latest) {
+        auto current = [&](size_t i) {
+            return ring.periods[i] == latest - 1 || ring.periods[i] == latest;
+        };
+        for (int64_t period : {latest - 1, latest}) {
+            if (ring.periods[0] == period || ring.periods[1] == period) {
+                continue;
+            }
+            size_t stale = current(0) ? 1 : 0;
+            ring.periods[stale] = period;
+            ring.views[stale].slots.clear();
+            ring.views[stale].best.clear();
+        }
+    }
+
+    void unlinkWindows(uint32_t slot) {
+        if (!windowsEnabled) {
+            return;
+        }
+        for (size_t w = 0; w < kWindowCount; ++w) {
+            TimeWindow &ring = windows[w];
+            int64_t period = periodOf(static_cast<LeaderboardWindow>(w), entries[slot].playedAt);
+            for (size_t i = 0; i < ring.periods.size(); ++i) {
+                if (period == kNoPeriod || ring.periods[i] != period) {
+                    continue;
+                }
+                // Rows older than the ring were never linked; with one row per
+                // player the name index says whether this slot is in the bucket.
+                RankedView &view = ring.views[i];
+                auto found = view.best.find(entries[slot].name);
+                if (found != view.best.end() && found->second == slot) {
+                    size_t index = locate(view, slot);
+                    if (index < view.slots.size()) {
+                        unlink(view, index);
+                    }
+                }
+            }
+        }
+    }
+
+    void rebuildColumns() {
+        columns.clear();
+        columns.reserve(entries.size());
+        for (const auto &entry : entries) {
+            columns.append(entry);
+        }
+    }
+
+    void rebuildWindows() {
+        for (size_t w = 0; w < kWindowCount; ++w) {
+            rebuildWindow(w);
+        }
+    }
+
+    // Same rule as linkWindows(), with the newest period present in the data.
+    // Disabled windows are left empty.
+    void rebuildWindow(size_t w) {
+        TimeWindow &ring = windows[w];
+        LeaderboardWindow window = static_cast<LeaderboardWindow>(w);
+        ring.periods = {{kNoPeriod, kNoPeriod}};
+        for (RankedView &view : ring.views) {
+            view.slots.clear();
+            view.best.clear();
+        }
+        int64_t latest = kNoPeriod;
+        for (size_t slot = 0; windowsEnabled && slot < entries.size(); ++slot) {
+            latest = max(latest, periodOf(window, entries[slot].playedAt));
+        }
+        if (latest == kNoPeriod) {
+            return;
+        }
+        ring.periods = {{latest - 1, latest}};
+        for (uint32_t slot = 0; slot < entries.size(); ++slot) {
+            int64_t period = periodOf(window, entries[slot].playedAt);
+            if (period == latest || period == latest - 1) {
+                RankedView &view = ring.views[period == latest ? 1 : 0];
+                view.slots.push_back(slot);
+                noteBest(view, slot);
+            }
+        }
+        for (RankedView &view : ring.views) {
+            sortView(view);
+        }
+    }
+
+    vector<LeaderboardEntry> entries;
+    array<RankedView, kViewCount> views;
+    array<TimeWindow, kWindowCount> windows;
+    LeaderboardColumns columns;
+    size_t nameBytes{0};
+    bool windowsEnabled{true};
+    size_t sortThreads{defaultSortThreads()};
+    SortAlgorithm sortAlgorithm{SortAlgorithm::AUTO};
 };
 
 class WordScrambleGame {
 public:
     WordScrambleGame() {
+        MemoryScope scope(MemorySubsystem::DICTIONARY);
         initializeDefaultWords();
         updateMemoryUsage();
     }
 
     static bool caseInsensitiveCompare(const string &lhs, const string &rhs) {
-        return toLowerCase(lhs) == toLowerCase(rhs);
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            if (::tolower(static_cast<unsigned char>(lhs[i])) != ::tolower(static_cast<unsigned char>(rhs[i]))) {
+                return false;
+            }
+        }
+        return true;
     }
 
     static string toLowerCase(const string &value) {
@@ -67,7 +3046,7 @@ public:
         if (word.empty()) {
             return false;
         }
-        if (word.size() < 2 || word.size() > 20) {
+        if (word.size() < kMinWordLength || word.size() > kMaxWordLength) {
             return false;
         }
         static const regex pattern("^[A-Za-z]+$");
@@ -75,26 +3054,148 @@ public:
     }
 
     bool addWord(const string &word) {
+        WS_TRACE_SPAN("WordScrambleGame::addWord");
+        MemoryScope scope(MemorySubsystem::DICTIONARY);
         string trimmed = trim(word);
         if (!isValidWord(trimmed)) {
             return false;
         }
-        string lowered = toLowerCase(trimmed);
-        if (uniqueWords.count(lowered) != 0) {
+        if (dedupFilterEnabled) {
+            return addWordThroughFilter(trimmed);
+        }
+        uint64_t hash = caseInsensitiveHash(trimmed);
+        if (uniqueWords.contains(trimmed, hash, words)) {
+            return false;
+        }
+        appendWord(trimmed, hash);
+        updateMemoryUsage();
+        return true;
+    }
+
+    // Puts a Bloom filter in front of the duplicate check for bulk imports.
+    // Words the filter has never seen skip the hash-set lookup; the filter
+    // is resized and refilled from the word list when it outgrows its sizing.
+    void enableDedupFilter(size_t expectedWords) {
+        MemoryScope scope(MemorySubsystem::DICTIONARY);
+        dedupFilterEnabled = true;
+        rebuildDedupFilter(max(expectedWords, words.size() * 2));
+    }
+
+    void disableDedupFilter() {
+        dedupFilterEnabled = false;
+        dedupFilter = BlockedBloomFilter{};
+        updateMemoryUsage();
+    }
+
+    static string anagramSignature(const string &word) {
+        string signature = toLowerCase(word);
+        sort(signature.begin(), signature.end());
+        return signature;
+    }
+
+    // Number of dictionary words that can be spelled with exactly these letters.
+    size_t countSolutions(const string &scramble) const {
+        if (compactDictionaryLoaded) {
+            size_t count = 0;
+            forEachAnagram(scramble, [&](const string &) {
+                ++count;
+            });
+            return count;
+        }
+        LetterSignature signature = LetterSignature::of(scramble);
+        auto it = anagramIndex.find(signature);
+        if (it == anagramIndex.end()) {
+            return 0;
+        }
+        if (!signature.saturated()) {
+            return it->second.size();
+        }
+        return static_cast<size_t>(count_if(it->second.begin(), it->second.end(), [&](uint32_t index) {
+            return sameLetters(words[index], scramble);
+        }));
+    }
+
+    vector<string> findAnagrams(const string &letters) const {
+        vector<string> matches;
+        forEachAnagram(letters, [&](const string &word) {
+            matches.push_back(word);
+        });
+        return matches;
+    }
+
+    // Every dictionary word that can be spelled from a subset of `letters`.
+    vector<string> findBuildableWords(const string &letters, size_t minLength = 2) const {
+        vector<string> matches;
+        forEachBuildableWord(letters, [&](const string &word) {
+            if (word.size() >= minLength) {
+                matches.push_back(word);
+            }
+        });
+        return matches;
+    }
+
+    size_t countBuildableWords(const string &letters) const {
+        size_t count = 0;
+        forEachBuildableWord(letters, [&](const string &) {
+            ++count;
+        });
+        return count;
+    }
+
+    // Writes the current word list as a minimised DAWG.
+    bool saveCompactDictionary(const string &filename) {
+        WS_TRACE_SPAN("WordScrambleGame::saveCompactDictionary");
+        uint64_t start = MetricsClock::now();
+        if (!compactDictionary().saveToFile(filename)) {
+            return false;
+        }
+        metrics.bytesWritten += compactDictionaryIndex.serializedBytes();
+        recordFileOperation(start);
+        return true;
+    }
+
+    // Makes a saved DAWG the source for selectRandomWord(), prefix queries and
+    // anagram acceptance, without expanding it into the word list. Anagram and
+    // buildable-word queries then cover the word list plus the DAWG.
+    bool loadCompactDictionaryFromFile(const string &filename) {
+        WS_TRACE_SPAN("WordScrambleGame::loadCompactDictionaryFromFile");
+        MemoryScope scope(MemorySubsystem::DICTIONARY);
+        uint64_t start = MetricsClock::now();
+        if (!compactDictionaryIndex.loadFromFile(filename)) {
             return false;
         }
-        words.push_back(trimmed);
-        uniqueWords.insert(lowered);
+        metrics.bytesRead += compactDictionaryIndex.serializedBytes();
+        compactDictionaryLoaded = true;
+        compactDictionaryStale = false;
+        recordFileOperation(start);
         updateMemoryUsage();
         return true;
     }
 
+    size_t countWordsWithPrefix(const string &prefix) const {
+        return compactDictionary().countWithPrefix(prefix);
+    }
+
+    vector<string> wordsWithPrefix(const string &prefix, size_t limit) const {
+        return compactDictionary().wordsWithPrefix(prefix, limit);
+    }
+
+    void setAcceptAnagrams(bool accept) {
+        acceptAnagrams = accept;
+    }
+
+    bool getAcceptAnagrams() const {
+        return acceptAnagrams;
+    }
+
     const vector<string> &getWordList() const {
         return words;
     }
 
     bool loadWordsFromFile(const string &filename) {
-        auto start = steady_clock::now();
+        WS_TRACE_SPAN("WordScrambleGame::loadWordsFromFile");
+        MemoryScope scope(MemorySubsystem::DICTIONARY);
+        uint64_t start = MetricsClock::now();
         ifstream input(filename);
         if (!input.is_open()) {
             return false;
@@ -102,6 +3203,7 @@ public:
 
         string line;
         while (getline(input, line)) {
+            metrics.bytesRead += line.size() + 1;
             string trimmed = trim(line);
             if (trimmed.empty()) {
                 continue;
@@ -109,13 +3211,15 @@ public:
             addWord(trimmed);
         }
 
-        auto end = steady_clock::now();
-        metrics.fileOperations++;
-        metrics.totalFileIOTime += duration_cast<milliseconds>(end - start).count();
+        recordFileOperation(start);
         updateMemoryUsage();
         return true;
     }
 
+    void seedRandom(unsigned seed) {
+        rng.seed(seed);
+    }
+
     void setDifficulty(Difficulty level) {
         difficulty = level;
     }
@@ -125,18 +3229,25 @@ public:
     }
 
     string selectRandomWord() {
-        if (words.empty()) {
+        WS_TRACE_SPAN("WordScrambleGame::selectRandomWord");
+        MemoryScope scope(MemorySubsystem::SESSION);
+        if (compactDictionaryLoaded && !compactDictionaryIndex.empty()) {
+            uniform_int_distribution<size_t> dist(0, compactDictionaryIndex.size() - 1);
+            currentWord = compactDictionaryIndex.wordAt(dist(rng));
+        } else if (words.empty()) {
             return "";
+        } else {
+            uniform_int_distribution<size_t> dist(0, words.size() - 1);
+            currentWord = words[dist(rng)];
         }
-
-        uniform_int_distribution<size_t> dist(0, words.size() - 1);
-        currentWord = words[dist(rng)];
-        revealedPositions.clear();
-        lastGuessStart = steady_clock::now();
+        currentSignature = LetterSignature::of(currentWord);
+        revealedMask = 0;
+        lastGuessStart = MetricsClock::now();
         return currentWord;
     }
 
     string scrambleWord(const string &word) {
+        WS_TRACE_SPAN("WordScrambleGame::scrambleWord");
         string scrambled = word;
         if (scrambled.size() > 1) {
             shuffle(scrambled.begin(), scrambled.end(), rng);
@@ -146,22 +3257,24 @@ public:
     }
 
     bool checkGuess(const string &guess) {
-        auto now = steady_clock::now();
-        if (lastGuessStart.time_since_epoch().count() != 0) {
-            auto delta = duration_cast<milliseconds>(now - lastGuessStart).count();
-            if (delta <= 0) {
-                delta = 1;
-            }
-            metrics.totalGuessTime += static_cast<double>(delta);
-        } else {
-            metrics.totalGuessTime += 1.0;
+        WS_TRACE_SPAN("WordScrambleGame::checkGuess");
+        uint64_t now = MetricsClock::now();
+        if (lastGuessStart != 0) {
+            uint64_t delta = MetricsClock::elapsed(lastGuessStart, now);
+            metrics.totalGuessTimeNs += delta;
+            metrics.guessLatency.record(delta);
         }
         metrics.guessCount++;
-        lastGuessStart = steady_clock::now();
+        lastGuessStart = now;
 
         totalGuesses++;
         attempts++;
-        bool correct = caseInsensitiveCompare(guess, currentWord);
+        // Anything that is not a permutation of the answer is rejected
+        // without touching the word or the dictionary.
+        LetterSignature guessSignature = LetterSignature::of(guess);
+        bool correct = !currentWord.empty() && guessSignature == currentSignature
+                       && (caseInsensitiveCompare(guess, currentWord)
+                           || (acceptAnagrams && isDictionaryAnagram(guess, guessSignature)));
         if (correct) {
             correctGuesses++;
         }
@@ -169,228 +3282,554 @@ public:
         return correct;
     }
 
-    void updateScore() {
-        if (currentWord.empty() || !lastGuessCorrect) {
-            return;
-        }
-        int baseScore = static_cast<int>(currentWord.size()) * 10;
-        auto it = customScores.find(static_cast<int>(currentWord.size()));
-        if (it != customScores.end()) {
-            baseScore = it->second;
-        }
-        double multiplier = getDifficultyMultiplier();
-        score += static_cast<int>(std::round(baseScore * multiplier));
-        updateMemoryUsage();
+    void updateScore() {
+        WS_TRACE_SPAN("WordScrambleGame::updateScore");
+        if (currentWord.empty() || !lastGuessCorrect) {
+            return;
+        }
+        uint64_t start = MetricsClock::now();
+        int baseScore = static_cast<int>(currentWord.size()) * 10;
+        auto it = customScores.find(static_cast<int>(currentWord.size()));
+        if (it != customScores.end()) {
+            baseScore = it->second;
+        }
+        double multiplier = getDifficultyMultiplier();
+        score += static_cast<int>(std::round(baseScore * multiplier));
+        updateMemoryUsage();
+        metrics.scoringLatency.record(MetricsClock::elapsed(start, MetricsClock::now()));
+    }
+
+    void resetAttempts() {
+        attempts = 0;
+    }
+
+    // Starts a fresh player session; dictionary, leaderboard and metrics are kept.
+    void resetSession() {
+        currentWord.clear();
+        currentSignature = LetterSignature{};
+        revealedMask = 0;
+        lastGuessCorrect = false;
+        totalGuesses = 0;
+        correctGuesses = 0;
+        attempts = 0;
+        score = 0;
+        gamesPlayed = 0;
+        lastGuessStart = 0;
+    }
+
+    void setPlayerName(const string &name) {
+        MemoryScope scope(MemorySubsystem::SESSION);
+        playerName = name;
+        updateMemoryUsage();
+    }
+
+    const string &getCurrentWord() const {
+        return currentWord;
+    }
+
+    int getScore() const {
+        return score;
+    }
+
+    bool updateLeaderboard(double averageRoundTime) {
+        return updateLeaderboard(averageRoundTime, epochSeconds());
+    }
+
+    // `playedAt` is Unix seconds; it decides which daily and weekly boards the row lands on.
+    // A non-finite round time is rejected, since the loader would drop the saved row.
+    bool updateLeaderboard(double averageRoundTime, int64_t playedAt) {
+        WS_TRACE_SPAN("WordScrambleGame::updateLeaderboard");
+        if (!std::isfinite(averageRoundTime)) {
+            return false;
+        }
+        MemoryScope scope(MemorySubsystem::LEADERBOARD);
+        LeaderboardEntry entry;
+        entry.name = playerName.empty() ? string("Player") : playerName;
+        entry.score = score;
+        entry.games = ++gamesPlayed;
+        entry.attempts = attempts > 0 ? attempts : static_cast<int>(totalGuesses);
+        entry.averageTime = averageRoundTime;
+        entry.accuracy = totalGuesses == 0 ? 0.0 : (static_cast<double>(correctGuesses) / totalGuesses) * 100.0;
+        entry.averageGuessTime = metrics.guessLatency.count() == 0 ? 0.0 : metrics.guessLatency.mean() / 1e6;
+        entry.difficulty = difficulty;
+        entry.playedAt = playedAt;
+        if (leaderboardMode == LeaderboardMode::APPEND_ALL) {
+            leaderboard.insert(std::move(entry));
+        } else {
+            leaderboard.upsert(std::move(entry), leaderboardMode == LeaderboardMode::KEEP_LATEST);
+        }
+        updateMemoryUsage();
+        return true;
+    }
+
+    bool saveMetricsToFile(const string &filename) {
+        WS_TRACE_SPAN("WordScrambleGame::saveMetricsToFile");
+        uint64_t start = MetricsClock::now();
+        ofstream output(filename);
+        if (!output.is_open()) {
+            return false;
+        }
+        output << "Player: " << (playerName.empty() ? string("Player") : playerName) << '\n';
+        output << "Score: " << score << '\n';
+        output << "Accuracy: " << fixed << setprecision(1) << (totalGuesses == 0 ? 0.0 : (static_cast<double>(correctGuesses) / totalGuesses) * 100.0) << "%\n";
+        output << "Guesses: " << totalGuesses << '\n';
+        output << "Correct: " << correctGuesses << '\n';
+        output << "Total Guess Time: " << formatDuration(metrics.totalGuessTimeNs) << '\n';
+        output << "File I/O Operations: " << metrics.fileOperations << '\n';
+        output << "Total File I/O Time: " << formatDuration(metrics.totalFileIOTimeNs) << '\n';
+        output << "Scrambles: " << metrics.scrambleCount << '\n';
+        if (metrics.dedupFilterQueries != 0) {
+            output << "Dedup Filter Queries: " << metrics.dedupFilterQueries << '\n';
+            output << "Dedup Filter Rejections: " << metrics.dedupFilterRejections << '\n';
+            output << "Dedup Filter False Positives: " << metrics.dedupFilterFalsePositives << '\n';
+        }
+        output << "Total Memory: " << metrics.totalMemoryAllocated << " bytes\n";
+        output << "Peak Memory: " << metrics.peakMemoryUsage << " bytes\n";
+        for (size_t i = 0; i < kMemorySubsystemCount; ++i) {
+            output << "Memory (" << memorySubsystemName(static_cast<MemorySubsystem>(i)) << "): "
+                   << metrics.liveBytesBySubsystem[i] << " bytes live, " << metrics.peakBytesBySubsystem[i] << " bytes peak\n";
+        }
+        writeLatencySummary(output, "Guess Time", metrics.guessLatency);
+        writeLatencySummary(output, "File I/O Time", metrics.fileIOLatency);
+        writeLatencySummary(output, "Scoring Time", metrics.scoringLatency);
+        metrics.bytesWritten += static_cast<uint64_t>(output.tellp());
+        output.close();
+        recordFileOperation(start);
+        return true;
+    }
+
+    bool saveMetricsToFile(const string &filename, MetricsFormat format) {
+        WS_TRACE_SPAN("WordScrambleGame::saveMetricsToFile");
+        if (format == MetricsFormat::TEXT) {
+            return saveMetricsToFile(filename);
+        }
+        uint64_t start = MetricsClock::now();
+        ofstream output(filename, ios::binary);
+        if (!output.is_open()) {
+            return false;
+        }
+        exportMetrics(exportBuffer, format);
+        output.write(exportBuffer.data(), static_cast<streamsize>(exportBuffer.size()));
+        metrics.bytesWritten += exportBuffer.size();
+        output.close();
+        recordFileOperation(start);
+        return true;
+    }
+
+    // Rebuilds `out` in place so a poller can reuse one buffer across scrapes.
+    void exportMetrics(string &out, MetricsFormat format) const {
+        WS_TRACE_SPAN("WordScrambleGame::exportMetrics");
+        out.clear();
+        if (format == MetricsFormat::JSON) {
+            exportMetricsJson(out);
+        } else {
+            exportMetricsPrometheus(out);
+        }
+    }
+
+    bool saveLeaderboardToFile(const string &filename) {
+        WS_TRACE_SPAN("WordScrambleGame::saveLeaderboardToFile");
+        uint64_t start = MetricsClock::now();
+        ofstream output(filename);
+        if (!output.is_open()) {
+            return false;
+        }
+        output << kLeaderboardCsvHeader << '\n';
+        leaderboard.forEachInRange(leaderboard.view(LeaderboardStore::kGlobalView), 0, leaderboard.size(), [&](const LeaderboardEntry &entry, size_t rank) {
+            writeLeaderboardRow(output, entry, rank);
+        });
+        metrics.bytesWritten += static_cast<uint64_t>(output.tellp());
+        output.close();
+        recordFileOperation(start);
+        return true;
+    }
+
+    bool loadLeaderboardFromFile(const string &filename) {
+        WS_TRACE_SPAN("WordScrambleGame::loadLeaderboardFromFile");
+        MemoryScope scope(MemorySubsystem::LEADERBOARD);
+        uint64_t start = MetricsClock::now();
+        ifstream input(filename);
+        if (!input.is_open()) {
+            return false;
+        }
+        vector<LeaderboardEntry> loaded;
+        string line;
+        bool headerSkipped = false;
+        while (getline(input, line)) {
+            metrics.bytesRead += line.size() + 1;
+            if (!headerSkipped) {
+                headerSkipped = true;
+                if (line.find("RANK") != string::npos) {
+                    continue;
+                }
+            }
+            LeaderboardEntry entry;
+            if (parseLeaderboardRow(line, entry)) {
+                loaded.push_back(entry);
+            }
+        }
+        leaderboard.assign(std::move(loaded));
+        if (leaderboardMode != LeaderboardMode::APPEND_ALL) {
+            leaderboard.collapseByName(leaderboardMode == LeaderboardMode::KEEP_LATEST);
+        }
+        recordFileOperation(start);
+        updateMemoryUsage();
+        return true;
+    }
+
+    // k-way merge of shard files written by saveLeaderboardToFile() into one
+    // re-ranked file. Shards are read a row at a time and the heap holds one row
+    // per shard, so memory stays O(shards) however large the inputs are. Ties keep
+    // shard order, which matches loading the concatenated shards. Every row is
+    // kept, as in APPEND_ALL. Rows go to `filename`.tmp, which replaces `filename`
+    // only once every row is written. Fails, leaving `filename` untouched, if a
+    // file cannot be opened or written or a shard is out of leaderboard order.
+    bool mergeLeaderboardFiles(const vector<string> &shards, const string &filename) {
+        WS_TRACE_SPAN("WordScrambleGame::mergeLeaderboardFiles");
+        uint64_t start = MetricsClock::now();
+        vector<ShardCursor> cursors(shards.size());
+        for (size_t i = 0; i < shards.size(); ++i) {
+            cursors[i].input.open(shards[i]);
+            if (!cursors[i].input.is_open()) {
+                return false;
+            }
+        }
+        string staging = filename + ".tmp";
+        ofstream output(staging);
+        if (!output.is_open()) {
+            return false;
+        }
+        output << kLeaderboardCsvHeader << '\n';
+        // priority_queue pops its greatest element, so "less" means ranks below.
+        auto ranksBelow = [&cursors](size_t lhs, size_t rhs) {
+            const LeaderboardEntry &left = cursors[lhs].entry;
+            const LeaderboardEntry &right = cursors[rhs].entry;
+            if (LeaderboardStore::outranks(right, left)) {
+                return true;
+            }
+            if (LeaderboardStore::outranks(left, right)) {
+                return false;
+            }
+            return lhs > rhs;
+        };
+        priority_queue<size_t, vector<size_t>, decltype(ranksBelow)> heap(ranksBelow);
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            if (readShardRow(cursors[i])) {
+                heap.push(i);
+            }
+        }
+        bool ordered = true;
+        size_t rank = 0;
+        LeaderboardEntry previous;
+        while (!heap.empty() && ordered && output) {
+            size_t shard = heap.top();
+            heap.pop();
+            ShardCursor &cursor = cursors[shard];
+            writeLeaderboardRow(output, cursor.entry, ++rank);
+            previous.score = cursor.entry.score;
+            previous.accuracy = cursor.entry.accuracy;
+            if (readShardRow(cursor)) {
+                ordered = !LeaderboardStore::outranks(cursor.entry, previous);
+                heap.push(shard);
+            }
+        }
+        metrics.bytesWritten += static_cast<uint64_t>(max<streamoff>(output.tellp(), 0));
+        output.close();
+        recordFileOperation(start);
+        if (!ordered || output.fail() || std::rename(staging.c_str(), filename.c_str()) != 0) {
+            std::remove(staging.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    void displayLeaderboard() const {
+        displayLeaderboard(0, leaderboard.size());
+    }
+
+    // Prints up to `limit` rows starting at rank `offset + 1` with a single write.
+    void displayLeaderboard(size_t offset, size_t limit) const {
+        printLeaderboard(leaderboard.view(LeaderboardStore::kGlobalView), offset, limit);
+    }
+
+    // Same, ranked within one difficulty level.
+    void displayLeaderboard(Difficulty level, size_t offset, size_t limit) const {
+        printLeaderboard(leaderboard.view(LeaderboardStore::viewFor(level)), offset, limit);
+    }
+
+    // Today's or this week's board (UTC), ranked within that period only; shown
+    // as empty in KEEP_BEST, see leaderboardWindowsAvailable().
+    void displayLeaderboard(LeaderboardWindow window, size_t offset, size_t limit) const {
+        printLeaderboard(windowView(window, epochSeconds()), offset, limit);
+    }
+
+    void renderLeaderboard(string &out, size_t offset, size_t limit) const {
+        renderView(out, leaderboard.view(LeaderboardStore::kGlobalView), offset, limit);
+    }
+
+    void renderLeaderboard(string &out, Difficulty level, size_t offset, size_t limit) const {
+        renderView(out, leaderboard.view(LeaderboardStore::viewFor(level)), offset, limit);
+    }
+
+    // Switching to an upsert mode collapses existing duplicates immediately.
+    // Windows are dropped before a KEEP_BEST collapse and rebuilt after leaving it.
+    void setLeaderboardMode(LeaderboardMode mode) {
+        MemoryScope scope(MemorySubsystem::LEADERBOARD);
+        leaderboardMode = mode;
+        if (mode == LeaderboardMode::KEEP_BEST) {
+            leaderboard.setWindowsEnabled(false);
+        }
+        if (mode != LeaderboardMode::APPEND_ALL) {
+            leaderboard.collapseByName(mode == LeaderboardMode::KEEP_LATEST);
+        }
+        leaderboard.setWindowsEnabled(leaderboardWindowsAvailable());
+        updateMemoryUsage();
+    }
+
+    // Threads used to rank rows in loadLeaderboardFromFile(); 0 means one per core.
+    void setLeaderboardSortThreads(size_t threads) {
+        leaderboard.setSortThreads(threads == 0 ? defaultSortThreads() : threads);
+    }
+
+    void setLeaderboardSortAlgorithm(SortAlgorithm algorithm) {
+        leaderboard.setSortAlgorithm(algorithm);
+    }
+
+    LeaderboardMode getLeaderboardMode() const {
+        return leaderboardMode;
+    }
+
+    // O(1) lookup of the player's best row; rank is filled in with one binary search.
+    bool findLeaderboardEntry(const string &name, LeaderboardEntry &entry) const {
+        const LeaderboardEntry *found = leaderboard.find(name);
+        if (found == nullptr) {
+            return false;
+        }
+        entry = *found;
+        entry.rank = static_cast<int>(leaderboard.rankOf(name));
+        return true;
+    }
+
+    size_t leaderboardSize() const {
+        return leaderboard.size();
+    }
+
+    size_t leaderboardSize(Difficulty level) const {
+        return leaderboard.view(LeaderboardStore::viewFor(level)).slots.size();
+    }
+
+    vector<LeaderboardEntry> leaderboardTop(size_t count) const {
+        return pageOf(leaderboard.view(LeaderboardStore::kGlobalView), 0, count);
+    }
+
+    vector<LeaderboardEntry> leaderboardTop(Difficulty level, size_t count) const {
+        return pageOf(leaderboard.view(LeaderboardStore::viewFor(level)), 0, count);
+    }
+
+    // Rows ranked offset + 1 .. offset + limit, with rank filled in.
+    vector<LeaderboardEntry> leaderboardPage(size_t offset, size_t limit) const {
+        return pageOf(leaderboard.view(LeaderboardStore::kGlobalView), offset, limit);
+    }
+
+    // Ranks in the per-difficulty overloads count only rows of that level.
+    vector<LeaderboardEntry> leaderboardPage(Difficulty level, size_t offset, size_t limit) const {
+        return pageOf(leaderboard.view(LeaderboardStore::viewFor(level)), offset, limit);
+    }
+
+    // Rank of the player's best entry, or 0 if they are not on the board.
+    size_t leaderboardRankOf(const string &name) const {
+        return leaderboard.rankOf(name);
+    }
+
+    size_t leaderboardRankOf(const string &name, Difficulty level) const {
+        return leaderboard.rankOf(name, leaderboard.view(LeaderboardStore::viewFor(level)));
+    }
+
+    // The player's best entry with up to `radius` rows either side of it.
+    vector<LeaderboardEntry> leaderboardAround(const string &name, size_t radius) const {
+        return aroundOf(leaderboard.view(LeaderboardStore::kGlobalView), name, radius);
+    }
+
+    vector<LeaderboardEntry> leaderboardAround(const string &name, Difficulty level, size_t radius) const {
+        return aroundOf(leaderboard.view(LeaderboardStore::viewFor(level)), name, radius);
+    }
+
+    // Mean score, accuracy and times over every stored row (each game in
+    // APPEND_ALL, each player's kept row in the upsert modes).
+    LeaderboardAggregate leaderboardAggregate() const {
+        WS_TRACE_SPAN("WordScrambleGame::leaderboardAggregate");
+        return leaderboard.analytics().aggregate();
+    }
+
+    LeaderboardAggregate leaderboardAggregate(Difficulty level) const {
+        WS_TRACE_SPAN("WordScrambleGame::leaderboardAggregate");
+        return leaderboard.analytics().aggregate(level);
+    }
+
+    LeaderboardStatistics leaderboardStatistics() const {
+        WS_TRACE_SPAN("WordScrambleGame::leaderboardStatistics");
+        return leaderboard.analytics().statistics();
+    }
+
+    LeaderboardStatistics leaderboardStatistics(Difficulty level) const {
+        WS_TRACE_SPAN("WordScrambleGame::leaderboardStatistics");
+        return leaderboard.analytics().statistics(level);
     }
 
-    void resetAttempts() {
-        attempts = 0;
+    ScoreHistogram leaderboardScoreHistogram(int bucketWidth) const {
+        WS_TRACE_SPAN("WordScrambleGame::leaderboardScoreHistogram");
+        return leaderboard.analytics().scoreHistogram(bucketWidth);
     }
 
-    void setPlayerName(const string &name) {
-        playerName = name;
-        updateMemoryUsage();
+    // KEEP_BEST keeps each player's all-time best row, not the games played in a
+    // period, so it cannot answer daily or weekly boards; their queries come back
+    // empty in that mode.
+    bool leaderboardWindowsAvailable() const {
+        return leaderboardMode != LeaderboardMode::KEEP_BEST;
     }
 
-    const string &getCurrentWord() const {
-        return currentWord;
+    // Windowed boards cover the newest period that received a row and the one before it; others come back empty.
+    // In KEEP_LATEST a player shows up only in the period of their latest game.
+    size_t leaderboardWindowSize(LeaderboardWindow window, int64_t at) const {
+        return windowView(window, at).slots.size();
     }
 
-    int getScore() const {
-        return score;
+    size_t leaderboardWindowSize(LeaderboardWindow window) const {
+        return leaderboardWindowSize(window, epochSeconds());
     }
 
-    void updateLeaderboard(double averageRoundTime) {
-        LeaderboardEntry entry;
-        entry.name = playerName.empty() ? string("Player") : playerName;
-        entry.score = score;
-        entry.games = ++gamesPlayed;
-        entry.attempts = attempts > 0 ? attempts : static_cast<int>(totalGuesses);
-        entry.averageTime = averageRoundTime;
-        entry.accuracy = totalGuesses == 0 ? 0.0 : (static_cast<double>(correctGuesses) / totalGuesses) * 100.0;
-        entry.averageGuessTime = metrics.guessCount == 0 ? 0.0 : metrics.totalGuessTime / static_cast<double>(metrics.guessCount);
-        entry.difficulty = difficulty;
-        leaderboard.push_back(entry);
-        sort(leaderboard.begin(), leaderboard.end(), [](const LeaderboardEntry &lhs, const LeaderboardEntry &rhs) {
-            if (lhs.score == rhs.score) {
-                return lhs.accuracy > rhs.accuracy;
-            }
-            return lhs.score > rhs.score;
-        });
-        for (size_t i = 0; i < leaderboard.size(); ++i) {
-            leaderboard[i].rank = static_cast<int>(i + 1);
-        }
-        updateMemoryUsage();
+    vector<LeaderboardEntry> leaderboardWindowPage(LeaderboardWindow window, int64_t at, size_t offset, size_t limit) const {
+        return pageOf(windowView(window, at), offset, limit);
     }
 
-    bool saveMetricsToFile(const string &filename) {
-        auto start = steady_clock::now();
-        ofstream output(filename);
-        if (!output.is_open()) {
-            return false;
-        }
-        output << "Player: " << (playerName.empty() ? string("Player") : playerName) << '\n';
-        output << "Score: " << score << '\n';
-        output << "Accuracy: " << fixed << setprecision(1) << (totalGuesses == 0 ? 0.0 : (static_cast<double>(correctGuesses) / totalGuesses) * 100.0) << "%\n";
-        output << "Guesses: " << totalGuesses << '\n';
-        output << "Correct: " << correctGuesses << '\n';
-        output << "Total Guess Time: " << fixed << setprecision(2) << metrics.totalGuessTime << " ms\n";
-        output << "File I/O Operations: " << metrics.fileOperations << '\n';
-        output << "Total File I/O Time: " << fixed << setprecision(2) << metrics.totalFileIOTime << " ms\n";
-        output << "Scrambles: " << metrics.scrambleCount << '\n';
-        output << "Total Memory: " << metrics.totalMemoryAllocated << " bytes\n";
-        output << "Peak Memory: " << metrics.peakMemoryUsage << " bytes\n";
-        output.close();
-        auto end = steady_clock::now();
-        metrics.fileOperations++;
-        metrics.totalFileIOTime += duration_cast<milliseconds>(end - start).count();
-        return true;
+    vector<LeaderboardEntry> leaderboardWindowPage(LeaderboardWindow window, size_t offset, size_t limit) const {
+        return leaderboardWindowPage(window, epochSeconds(), offset, limit);
     }
 
-    bool saveLeaderboardToFile(const string &filename) {
-        auto start = steady_clock::now();
-        ofstream output(filename);
-        if (!output.is_open()) {
-            return false;
-        }
-        output << "RANK,NAME,SCORE,GAMES,ATTEMPTS,AVG_TIME,ACCURACY,AVG_GUESS_TIME,DIFFICULTY" << '\n';
-        for (const auto &entry : leaderboard) {
-            output << entry.rank << ','
-                   << entry.name << ','
-                   << entry.score << ','
-                   << entry.games << ','
-                   << entry.attempts << ','
-                   << fixed << setprecision(2) << entry.averageTime << ','
-                   << fixed << setprecision(2) << entry.accuracy << ','
-                   << fixed << setprecision(2) << entry.averageGuessTime << ','
-                   << static_cast<int>(entry.difficulty) << '\n';
-        }
-        output.close();
-        auto end = steady_clock::now();
-        metrics.fileOperations++;
-        metrics.totalFileIOTime += duration_cast<milliseconds>(end - start).count();
-        return true;
+    size_t leaderboardWindowRankOf(const string &name, LeaderboardWindow window, int64_t at) const {
+        return leaderboard.rankOf(name, windowView(window, at));
     }
 
-    bool loadLeaderboardFromFile(const string &filename) {
-        auto start = steady_clock::now();
-        ifstream input(filename);
-        if (!input.is_open()) {
-            return false;
+    size_t leaderboardWindowRankOf(const string &name, LeaderboardWindow window) const {
+        return leaderboardWindowRankOf(name, window, epochSeconds());
+    }
+
+    HintResult requestHint(HintKind kind) {
+        WS_TRACE_SPAN("WordScrambleGame::requestHint");
+        HintResult result;
+        result.kind = kind;
+        if (currentWord.empty()) {
+            result.status = HintStatus::NO_WORD;
+            return result;
         }
-        vector<LeaderboardEntry> loaded;
-        string line;
-        bool headerSkipped = false;
-        while (getline(input, line)) {
-            if (!headerSkipped) {
-                headerSkipped = true;
-                if (line.find("RANK") != string::npos) {
-                    continue;
-                }
-            }
-            if (trim(line).empty()) {
-                continue;
-            }
-            vector<string> parts = split(line, ',');
-            if (parts.size() != 9) {
-                continue;
-            }
-            LeaderboardEntry entry;
-            try {
-                entry.rank = stoi(parts[0]);
-                entry.name = parts[1];
-                entry.score = stoi(parts[2]);
-                entry.games = stoi(parts[3]);
-                entry.attempts = stoi(parts[4]);
-                entry.averageTime = stod(parts[5]);
-                entry.accuracy = stod(parts[6]);
-                entry.averageGuessTime = stod(parts[7]);
-                int diff = stoi(parts[8]);
-                if (diff == 1) {
-                    entry.difficulty = Difficulty::EASY;
-                } else if (diff == 2) {
-                    entry.difficulty = Difficulty::MEDIUM;
-                } else if (diff == 3) {
-                    entry.difficulty = Difficulty::HARD;
-                } else {
-                    entry.difficulty = Difficulty::EASY;
-                }
-            } catch (const exception &) {
-                continue;
-            }
-            loaded.push_back(entry);
+        size_t revealable = min(currentWord.size(), kMaxRevealablePositions);
+        if (popCount(revealedMask) >= revealable) {
+            result.status = HintStatus::EXHAUSTED;
+            return result;
         }
-        leaderboard = std::move(loaded);
-        sort(leaderboard.begin(), leaderboard.end(), [](const LeaderboardEntry &lhs, const LeaderboardEntry &rhs) {
-            if (lhs.score == rhs.score) {
-                return lhs.accuracy > rhs.accuracy;
-            }
-            return lhs.score > rhs.score;
-        });
-        for (size_t i = 0; i < leaderboard.size(); ++i) {
-            leaderboard[i].rank = static_cast<int>(i + 1);
+        uint64_t hidden = ~revealedMask & (revealable == 64 ? UINT64_MAX : (uint64_t{1} << revealable) - 1);
+        uint64_t reveal = 0;
+        switch (kind) {
+        case HintKind::FIRST_LETTER:
+            reveal = 1;
+            break;
+        case HintKind::FIRST_AND_LAST:
+            reveal = 1 | (uint64_t{1} << (revealable - 1));
+            break;
+        case HintKind::NEXT_LETTER:
+            reveal = uint64_t{1} << nextUnrevealedPosition();
+            break;
+        case HintKind::RAREST_LETTER: {
+            size_t rarest = rarestHiddenPosition(hidden);
+            reveal = uint64_t{1} << rarest;
+            break;
         }
-        auto end = steady_clock::now();
-        metrics.fileOperations++;
-        metrics.totalFileIOTime += duration_cast<milliseconds>(end - start).count();
-        updateMemoryUsage();
-        return true;
+        case HintKind::VOWELS:
+            reveal = letterPositions(hidden, [](char ch) { return isVowel(ch); });
+            break;
+        case HintKind::PATTERN: {
+            char repeated = currentWord[mostRepeatedHiddenPosition(hidden)];
+            reveal = letterPositions(hidden, [&](char ch) {
+                return ::tolower(static_cast<unsigned char>(ch)) == ::tolower(static_cast<unsigned char>(repeated));
+            });
+            break;
+        }
+        }
+        // Re-revealing the first letter still answers a FIRST_LETTER request.
+        uint64_t fresh = reveal & hidden;
+        if (reveal == 0 || (fresh == 0 && kind != HintKind::FIRST_LETTER && kind != HintKind::FIRST_AND_LAST)) {
+            result.status = HintStatus::NOT_APPLICABLE;
+            result.remaining = static_cast<uint8_t>(popCount(hidden));
+            return result;
+        }
+        revealedMask |= reveal;
+        size_t last = highestBitIndex(reveal);
+        result.status = HintStatus::REVEALED;
+        result.position = static_cast<uint8_t>(last);
+        result.letter = currentWord[last];
+        result.revealedMask = reveal;
+        result.remaining = static_cast<uint8_t>(popCount(hidden & ~reveal));
+        return result;
     }
 
-    void displayLeaderboard() const {
-        if (leaderboard.empty()) {
-            cout << "No leaderboard data available." << endl;
-            return;
+    // Writes the word with unrevealed letters as '_' into `buffer` (NUL
+    // terminated, truncated to fit) and returns the pattern length.
+    size_t revealedPattern(char *buffer, size_t capacity) const {
+        if (capacity == 0) {
+            return 0;
         }
-        cout << left << setw(5) << "Rank" << setw(15) << "Name" << setw(10) << "Score"
-             << setw(10) << "Games" << setw(12) << "Attempts" << setw(12) << "Avg Time"
-             << setw(12) << "Accuracy" << setw(15) << "Avg Guess" << setw(12) << "Difficulty" << endl;
-        for (const auto &entry : leaderboard) {
-            cout << left << setw(5) << entry.rank
-                 << setw(15) << entry.name
-                 << setw(10) << entry.score
-                 << setw(10) << entry.games
-                 << setw(12) << entry.attempts
-                 << setw(12) << fixed << setprecision(1) << entry.averageTime
-                 << setw(12) << fixed << setprecision(1) << entry.accuracy << "%"
-                 << setw(15) << fixed << setprecision(2) << entry.averageGuessTime
-                 << setw(12) << difficultyToString(entry.difficulty) << endl;
+        size_t length = min(currentWord.size(), capacity - 1);
+        for (size_t i = 0; i < length; ++i) {
+            bool shown = i < kMaxRevealablePositions && ((revealedMask >> i) & 1u) != 0;
+            buffer[i] = shown ? currentWord[i] : '_';
         }
+        buffer[length] = '\0';
+        return length;
     }
 
-    void showHint(int level) {
-        if (currentWord.empty()) {
-            cout << "No word selected." << endl;
+    void printHint(ostream &output, const HintResult &hint) const {
+        switch (hint.status) {
+        case HintStatus::NO_WORD:
+            output << "No word selected.\n";
             return;
-        }
-        if (revealedPositions.size() >= currentWord.size()) {
-            cout << "No more hints available." << endl;
+        case HintStatus::EXHAUSTED:
+            output << "No more hints available.\n";
+            return;
+        case HintStatus::NOT_APPLICABLE:
+            output << "No hint of that kind available.\n";
             return;
+        case HintStatus::REVEALED:
+            break;
         }
-        switch (level) {
-        case 1:
-            cout << "Starts with: " << currentWord.front() << endl;
-            revealedPositions.insert(0);
+        switch (hint.kind) {
+        case HintKind::FIRST_LETTER:
+            output << "Starts with: " << currentWord.front() << '\n';
             break;
-        case 2:
-            cout << "Starts with " << currentWord.front() << " ... ends with " << currentWord.back() << endl;
-            revealedPositions.insert(0);
-            revealedPositions.insert(currentWord.size() - 1);
+        case HintKind::FIRST_AND_LAST:
+            output << "Starts with " << currentWord.front() << " ... ends with " << currentWord.back() << '\n';
             break;
-        case 3:
-        default: {
-            size_t position = nextUnrevealedPosition();
-            if (position >= currentWord.size()) {
-                cout << "No more hints available." << endl;
-                return;
-            }
-            revealedPositions.insert(position);
-            cout << "Letter at position " << (position + 1) << " is '" << currentWord[position] << "'" << endl;
+        case HintKind::NEXT_LETTER:
+        case HintKind::RAREST_LETTER:
+            output << "Letter at position " << (hint.position + 1) << " is '" << hint.letter << "'\n";
+            break;
+        case HintKind::VOWELS:
+        case HintKind::PATTERN: {
+            char pattern[kMaxRevealablePositions + 1];
+            revealedPattern(pattern, sizeof(pattern));
+            output << "Pattern: " << pattern << '\n';
             break;
         }
         }
     }
 
+    // Console adapter over requestHint(): 1 = first letter, 2 = first and
+    // last, anything else = next hidden letter.
+    void showHint(int level) {
+        WS_TRACE_SPAN("WordScrambleGame::showHint");
+        HintKind kind = level == 1 ? HintKind::FIRST_LETTER : level == 2 ? HintKind::FIRST_AND_LAST : HintKind::NEXT_LETTER;
+        printHint(cout, requestHint(kind));
+    }
+
     void customizeScoring(int wordLength, int reward) {
         if (wordLength <= 0 || reward <= 0) {
             return;
@@ -398,16 +3837,37 @@ public:
         customScores[wordLength] = reward;
     }
 
-    Metrics getMetrics() const {
+    // Metrics carries the latency histograms, so callers read it in place and
+    // copy only when they need a snapshot.
+    const Metrics &getMetrics() const {
         return metrics;
     }
 
+    void mergeMetrics(const Metrics &other) {
+        metrics.merge(other);
+    }
+
+    static bool saveTraceToFile(const string &filename) {
+        return TraceRecorder::instance().writeChromeTrace(filename);
+    }
+
 private:
     vector<string> words;
-    unordered_set<string> uniqueWords;
-    vector<LeaderboardEntry> leaderboard;
+    FlatWordSet uniqueWords;
+    unordered_map<LetterSignature, vector<uint32_t>, LetterSignatureHash> anagramIndex;
+    bool acceptAnagrams{true};
+    mutable WordBuilderIndex wordBuilderIndex;
+    mutable bool wordBuilderStale{true};
+    BlockedBloomFilter dedupFilter;
+    bool dedupFilterEnabled{false};
+    mutable CompactDictionary compactDictionaryIndex;
+    mutable bool compactDictionaryStale{true};
+    bool compactDictionaryLoaded{false};
+    LeaderboardStore leaderboard;
+    LeaderboardMode leaderboardMode{LeaderboardMode::APPEND_ALL};
     unordered_map<int, int> customScores;
     string currentWord;
+    LetterSignature currentSignature;
     string playerName;
     bool lastGuessCorrect{false};
     size_t totalGuesses{0};
@@ -417,10 +3877,92 @@ private:
     int gamesPlayed{0};
     Difficulty difficulty{Difficulty::EASY};
     mutable Metrics metrics;
-    unordered_set<size_t> revealedPositions;
-    steady_clock::time_point lastGuessStart{};
+    // Bit i set once letter i has been given away. Every word source is capped at
+    // kMaxWordLength letters, so each position has a bit (see kMaxRevealablePositions).
+    uint64_t revealedMask{0};
+    uint64_t lastGuessStart{0};
+    size_t dictionaryHeapBytes{0};
+    uint64_t sessionStart{MetricsClock::now()};
+    string exportBuffer;
     mt19937 rng{static_cast<unsigned>(steady_clock::now().time_since_epoch().count())};
 
+    static constexpr const char *kLeaderboardCsvHeader =
+        "RANK,NAME,SCORE,GAMES,ATTEMPTS,AVG_TIME,ACCURACY,AVG_GUESS_TIME,DIFFICULTY,PLAYED_AT";
+
+    // One open shard in mergeLeaderboardFiles() and its current row.
+    struct ShardCursor {
+        ifstream input;
+        string line;
+        LeaderboardEntry entry;
+        bool headerSkipped{false};
+    };
+
+    bool readShardRow(ShardCursor &cursor) {
+        while (getline(cursor.input, cursor.line)) {
+            metrics.bytesRead += cursor.line.size() + 1;
+            if (!cursor.headerSkipped) {
+                cursor.headerSkipped = true;
+                if (cursor.line.find("RANK") != string::npos) {
+                    continue;
+                }
+            }
+            if (parseLeaderboardRow(cursor.line, cursor.entry)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void writeLeaderboardRow(ostream &output, const LeaderboardEntry &entry, size_t rank) {
+        output << rank << ','
+               << entry.name << ','
+               << entry.score << ','
+               << entry.games << ','
+               << entry.attempts << ','
+               << fixed << setprecision(2) << entry.averageTime << ','
+               << fixed << setprecision(2) << entry.accuracy << ','
+               << fixed << setprecision(2) << entry.averageGuessTime << ','
+               << static_cast<int>(entry.difficulty) << ','
+               << entry.playedAt << '\n';
+    }
+
+    // False for blank or malformed lines, which loaders skip.
+    static bool parseLeaderboardRow(const string &line, LeaderboardEntry &entry) {
+        if (trim(line).empty()) {
+            return false;
+        }
+        vector<string> parts = split(line, ',');
+        // Files written before PLAYED_AT existed have nine columns.
+        if (parts.size() != 9 && parts.size() != 10) {
+            return false;
+        }
+        try {
+            entry.rank = stoi(parts[0]);
+            entry.name = parts[1];
+            entry.score = stoi(parts[2]);
+            entry.games = stoi(parts[3]);
+            entry.attempts = stoi(parts[4]);
+            entry.averageTime = stod(parts[5]);
+            entry.accuracy = stod(parts[6]);
+            entry.averageGuessTime = stod(parts[7]);
+            int diff = stoi(parts[8]);
+            if (diff == 1) {
+                entry.difficulty = Difficulty::EASY;
+            } else if (diff == 2) {
+                entry.difficulty = Difficulty::MEDIUM;
+            } else if (diff == 3) {
+                entry.difficulty = Difficulty::HARD;
+            } else {
+                entry.difficulty = Difficulty::EASY;
+            }
+            entry.playedAt = parts.size() == 10 ? stoll(parts[9]) : 0;
+        } catch (const exception &) {
+            return false;
+        }
+        // stod accepts "nan" and "inf"; such rows would poison ranking and statistics.
+        return std::isfinite(entry.averageTime) && std::isfinite(entry.accuracy) && std::isfinite(entry.averageGuessTime);
+    }
+
     static string trim(const string &value) {
         size_t start = value.find_first_not_of(" \t\n\r");
         if (start == string::npos) {
@@ -430,6 +3972,163 @@ private:
         return value.substr(start, end - start + 1);
     }
 
+    void recordFileOperation(uint64_t start) {
+        uint64_t elapsed = MetricsClock::elapsed(start, MetricsClock::now());
+        metrics.fileOperations++;
+        metrics.totalFileIOTimeNs += elapsed;
+        metrics.fileIOLatency.record(elapsed);
+    }
+
+    struct DerivedRates {
+        double uptimeSeconds{0.0};
+        double guessesPerSecond{0.0};
+        double scramblesPerSecond{0.0};
+        double fileIOBytesPerSecond{0.0};
+    };
+
+    DerivedRates computeRates() const {
+        DerivedRates rates;
+        rates.uptimeSeconds = static_cast<double>(MetricsClock::elapsed(sessionStart, MetricsClock::now())) / 1e9;
+        if (rates.uptimeSeconds > 0.0) {
+            rates.guessesPerSecond = static_cast<double>(metrics.guessCount) / rates.uptimeSeconds;
+            rates.scramblesPerSecond = static_cast<double>(metrics.scrambleCount) / rates.uptimeSeconds;
+        }
+        if (metrics.totalFileIOTimeNs > 0) {
+            rates.fileIOBytesPerSecond = static_cast<double>(metrics.bytesRead + metrics.bytesWritten) * 1e9 / static_cast<double>(metrics.totalFileIOTimeNs);
+        }
+        return rates;
+    }
+
+    double accuracyPercent() const {
+        return totalGuesses == 0 ? 0.0 : (static_cast<double>(correctGuesses) / totalGuesses) * 100.0;
+    }
+
+    static void appendPrometheusMetric(MetricsBuffer &buffer, string_view name, string_view type, string_view help, double value) {
+        buffer.append("# HELP wordscramble_").append(name).append(' ').append(help).append('\n');
+        buffer.append("# TYPE wordscramble_").append(name).append(' ').append(type).append('\n');
+        buffer.append("wordscramble_").append(name).append(' ').append(value).append('\n');
+    }
+
+    static void appendPrometheusMetric(MetricsBuffer &buffer, string_view name, string_view type, string_view help, uint64_t value) {
+        buffer.append("# HELP wordscramble_").append(name).append(' ').append(help).append('\n');
+        buffer.append("# TYPE wordscramble_").append(name).append(' ').append(type).append('\n');
+        buffer.append("wordscramble_").append(name).append(' ').append(value).append('\n');
+    }
+
+    static void appendPrometheusSummary(MetricsBuffer &buffer, string_view name, string_view help, const LatencyHistogram &histogram) {
+        static const pair<const char *, double> quantiles[] = {{"0.5", 50.0}, {"0.9", 90.0}, {"0.99", 99.0}, {"0.999", 99.9}};
+        buffer.append("# HELP wordscramble_").append(name).append(' ').append(help).append('\n');
+        buffer.append("# TYPE wordscramble_").append(name).append(" summary\n");
+        for (const auto &quantile : quantiles) {
+            buffer.append("wordscramble_").append(name).append("{quantile=\"").append(quantile.first).append("\"} ")
+                .append(static_cast<double>(histogram.percentile(quantile.second)) / 1e9).append('\n');
+        }
+        buffer.append("wordscramble_").append(name).append("_sum ").append(static_cast<double>(histogram.sum()) / 1e9).append('\n');
+        buffer.append("wordscramble_").append(name).append("_count ").append(histogram.count()).append('\n');
+    }
+
+    void exportMetricsPrometheus(string &out) const {
+        MetricsBuffer buffer(out);
+        DerivedRates rates = computeRates();
+        appendPrometheusMetric(buffer, "score", "gauge", "Current player score.", static_cast<double>(score));
+        appendPrometheusMetric(buffer, "accuracy_percent", "gauge", "Share of guesses that were correct.", accuracyPercent());
+        appendPrometheusMetric(buffer, "guesses_total", "counter", "Guesses checked.", static_cast<uint64_t>(metrics.guessCount));
+        appendPrometheusMetric(buffer, "correct_guesses_total", "counter", "Correct guesses.", static_cast<uint64_t>(correctGuesses));
+        appendPrometheusMetric(buffer, "scrambles_total", "counter", "Words scrambled.", static_cast<uint64_t>(metrics.scrambleCount));
+        appendPrometheusMetric(buffer, "dedup_filter_queries_total", "counter", "addWord() calls checked against the Bloom filter.", metrics.dedupFilterQueries);
+        appendPrometheusMetric(buffer, "dedup_filter_rejections_total", "counter", "New words admitted without a hash-set lookup.", metrics.dedupFilterRejections);
+        appendPrometheusMetric(buffer, "dedup_filter_false_positives_total", "counter", "Filter hits that were not duplicates.", metrics.dedupFilterFalsePositives);
+        appendPrometheusMetric(buffer, "guess_time_seconds_total", "counter", "Think time across all guesses.", static_cast<double>(metrics.totalGuessTimeNs) / 1e9);
+        appendPrometheusMetric(buffer, "file_operations_total", "counter", "Completed file loads and saves.", static_cast<uint64_t>(metrics.fileOperations));
+        appendPrometheusMetric(buffer, "file_io_seconds_total", "counter", "Time spent in file loads and saves.", static_cast<double>(metrics.totalFileIOTimeNs) / 1e9);
+        appendPrometheusMetric(buffer, "file_read_bytes_total", "counter", "Bytes read by loaders.", metrics.bytesRead);
+        appendPrometheusMetric(buffer, "file_written_bytes_total", "counter", "Bytes written by savers.", metrics.bytesWritten);
+        appendPrometheusMetric(buffer, "memory_bytes", "gauge", "Estimated live engine memory.", static_cast<uint64_t>(metrics.totalMemoryAllocated));
+        appendPrometheusMetric(buffer, "memory_peak_bytes", "gauge", "Estimated peak engine memory.", static_cast<uint64_t>(metrics.peakMemoryUsage));
+        buffer.append("# HELP wordscramble_subsystem_memory_bytes Live heap bytes per engine subsystem.\n");
+        buffer.append("# TYPE wordscramble_subsystem_memory_bytes gauge\n");
+        for (size_t i = 0; i < kMemorySubsystemCount; ++i) {
+            buffer.append("wordscramble_subsystem_memory_bytes{subsystem=\"").append(memorySubsystemName(static_cast<MemorySubsystem>(i)))
+                .append("\"} ").append(static_cast<uint64_t>(metrics.liveBytesBySubsystem[i])).append('\n');
+        }
+        buffer.append("# HELP wordscramble_subsystem_memory_peak_bytes Peak heap bytes per engine subsystem.\n");
+        buffer.append("# TYPE wordscramble_subsystem_memory_peak_bytes gauge\n");
+        for (size_t i = 0; i < kMemorySubsystemCount; ++i) {
+            buffer.append("wordscramble_subsystem_memory_peak_bytes{subsystem=\"").append(memorySubsystemName(static_cast<MemorySubsystem>(i)))
+                .append("\"} ").append(static_cast<uint64_t>(metrics.peakBytesBySubsystem[i])).append('\n');
+        }
+        appendPrometheusMetric(buffer, "uptime_seconds", "gauge", "Seconds since the engine was created.", rates.uptimeSeconds);
+        appendPrometheusMetric(buffer, "guesses_per_second", "gauge", "Guesses per second of uptime.", rates.guessesPerSecond);
+        appendPrometheusMetric(buffer, "scrambles_per_second", "gauge", "Scrambles per second of uptime.", rates.scramblesPerSecond);
+        appendPrometheusMetric(buffer, "file_io_bytes_per_second", "gauge", "Bytes moved per second spent in file I/O.", rates.fileIOBytesPerSecond);
+        appendPrometheusSummary(buffer, "guess_latency_seconds", "Think time between guesses.", metrics.guessLatency);
+        appendPrometheusSummary(buffer, "file_io_latency_seconds", "Duration of file loads and saves.", metrics.fileIOLatency);
+        appendPrometheusSummary(buffer, "scoring_latency_seconds", "Duration of score updates.", metrics.scoringLatency);
+    }
+
+    static void appendJsonHistogram(MetricsBuffer &buffer, string_view name, const LatencyHistogram &histogram) {
+        buffer.append('"').append(name).append("\":{\"count\":").append(histogram.count())
+            .append(",\"sum_ns\":").append(histogram.sum())
+            .append(",\"min_ns\":").append(histogram.min())
+            .append(",\"p50_ns\":").append(histogram.percentile(50.0))
+            .append(",\"p90_ns\":").append(histogram.percentile(90.0))
+            .append(",\"p99_ns\":").append(histogram.percentile(99.0))
+            .append(",\"p999_ns\":").append(histogram.percentile(99.9))
+            .append(",\"max_ns\":").append(histogram.max()).append('}');
+    }
+
+    void exportMetricsJson(string &out) const {
+        MetricsBuffer buffer(out);
+        DerivedRates rates = computeRates();
+        buffer.append("{\"player\":").appendJsonString(playerName.empty() ? string_view("Player") : string_view(playerName))
+            .append(",\"score\":").append(static_cast<int64_t>(score))
+            .append(",\"accuracy_percent\":").append(accuracyPercent())
+            .append(",\"guesses\":").append(static_cast<uint64_t>(metrics.guessCount))
+            .append(",\"correct_guesses\":").append(static_cast<uint64_t>(correctGuesses))
+            .append(",\"scrambles\":").append(static_cast<uint64_t>(metrics.scrambleCount))
+            .append(",\"dedup_filter\":{\"queries\":").append(metrics.dedupFilterQueries)
+            .append(",\"rejections\":").append(metrics.dedupFilterRejections)
+            .append(",\"false_positives\":").append(metrics.dedupFilterFalsePositives).append('}')
+            .append(",\"total_guess_time_ns\":").append(metrics.totalGuessTimeNs)
+            .append(",\"file_operations\":").append(static_cast<uint64_t>(metrics.fileOperations))
+            .append(",\"total_file_io_time_ns\":").append(metrics.totalFileIOTimeNs)
+            .append(",\"bytes_read\":").append(metrics.bytesRead)
+            .append(",\"bytes_written\":").append(metrics.bytesWritten)
+            .append(",\"memory_bytes\":").append(static_cast<uint64_t>(metrics.totalMemoryAllocated))
+            .append(",\"peak_memory_bytes\":").append(static_cast<uint64_t>(metrics.peakMemoryUsage))
+            .append(",\"memory_by_subsystem\":{");
+        for (size_t i = 0; i < kMemorySubsystemCount; ++i) {
+            buffer.append(i == 0 ? "\"" : ",\"").append(memorySubsystemName(static_cast<MemorySubsystem>(i)))
+                .append("\":{\"live_bytes\":").append(static_cast<uint64_t>(metrics.liveBytesBySubsystem[i]))
+                .append(",\"peak_bytes\":").append(static_cast<uint64_t>(metrics.peakBytesBySubsystem[i])).append('}');
+        }
+        buffer.append('}')
+            .append(",\"rates\":{\"uptime_seconds\":").append(rates.uptimeSeconds)
+            .append(",\"guesses_per_second\":").append(rates.guessesPerSecond)
+            .append(",\"scrambles_per_second\":").append(rates.scramblesPerSecond)
+            .append(",\"file_io_bytes_per_second\":").append(rates.fileIOBytesPerSecond)
+            .append("},\"latency\":{");
+        appendJsonHistogram(buffer, "guess", metrics.guessLatency);
+        buffer.append(',');
+        appendJsonHistogram(buffer, "file_io", metrics.fileIOLatency);
+        buffer.append(',');
+        appendJsonHistogram(buffer, "scoring", metrics.scoringLatency);
+        buffer.append("}}\n");
+    }
+
+    static void writeLatencySummary(ostream &output, const string &label, const LatencyHistogram &histogram) {
+        output << label << " Samples: " << histogram.count() << '\n';
+        static const pair<const char *, double> quantiles[] = {{"p50", 50.0}, {"p90", 90.0}, {"p99", 99.0}, {"p999", 99.9}};
+        for (const auto &quantile : quantiles) {
+            output << label << ' ' << quantile.first << ": " << formatDuration(histogram.percentile(quantile.second)) << '\n';
+        }
+        output << label << " Max: " << formatDuration(histogram.max()) << '\n';
+    }
+
+    static constexpr size_t kMaxRevealablePositions = 64;
+    static_assert(kMaxWordLength <= kMaxRevealablePositions, "revealedMask needs one bit per letter");
+    static constexpr size_t kAnagramNodeBytes = sizeof(void *) + sizeof(LetterSignature) + sizeof(vector<uint32_t>) + sizeof(size_t) + 2 * kMallocOverhead;
+
     static vector<string> split(const string &value, char delimiter) {
         vector<string> parts;
         string token;
@@ -443,23 +4142,193 @@ private:
     void initializeDefaultWords() {
         static const vector<string> defaults{"puzzle", "challenge", "example", "solution"};
         for (const auto &word : defaults) {
-            words.push_back(word);
-            uniqueWords.insert(toLowerCase(word));
+            appendWord(word, caseInsensitiveHash(word));
         }
     }
 
-    void updateMemoryUsage() {
-        size_t total = 0;
-        total += words.size() * sizeof(string);
+    void appendWord(const string &word, uint64_t hash) {
+        auto inserted = anagramIndex.try_emplace(LetterSignature::of(word));
+        if (inserted.second) {
+            dictionaryHeapBytes += kAnagramNodeBytes;
+        }
+        uint32_t handle = static_cast<uint32_t>(words.size());
+        inserted.first->second.push_back(handle);
+        dictionaryHeapBytes += stringHeapBytes(word) + sizeof(uint32_t);
+        words.push_back(word);
+        uniqueWords.insertNew(handle, hash);
+        if (dedupFilterEnabled) {
+            dedupFilter.insert(hash);
+        }
+        wordBuilderStale = true;
+        compactDictionaryStale = !compactDictionaryLoaded;
+    }
+
+    bool addWordThroughFilter(const string &trimmed) {
+        if (dedupFilter.overloaded()) {
+            rebuildDedupFilter(dedupFilter.capacityKeys() * 2);
+        }
+        metrics.dedupFilterQueries++;
+        uint64_t hash = caseInsensitiveHash(trimmed);
+        if (!dedupFilter.mayContain(hash)) {
+            metrics.dedupFilterRejections++;
+        } else if (uniqueWords.contains(trimmed, hash, words)) {
+            return false;
+        } else {
+            metrics.dedupFilterFalsePositives++;
+        }
+        appendWord(trimmed, hash);
+        updateMemoryUsage();
+        return true;
+    }
+
+    void rebuildDedupFilter(size_t expectedWords) {
+        dedupFilter.reset(max<size_t>(expectedWords, 1024));
         for (const auto &word : words) {
-            total += word.size();
+            dedupFilter.insert(caseInsensitiveHash(word));
+        }
+        updateMemoryUsage();
+    }
+
+    static bool sameLetters(const string &lhs, const string &rhs) {
+        return anagramSignature(lhs) == anagramSignature(rhs);
+    }
+
+    // Built on the first query after the dictionary changes.
+    const WordBuilderIndex &wordBuilder() const {
+        if (wordBuilderStale) {
+            MemoryScope scope(MemorySubsystem::DICTIONARY);
+            wordBuilderIndex.build(words);
+            wordBuilderStale = false;
         }
-        total += uniqueWords.size() * sizeof(string);
-        total += leaderboard.size() * sizeof(LeaderboardEntry);
-        for (const auto &entry : leaderboard) {
-            total += entry.name.size();
+        return wordBuilderIndex;
+    }
+
+    // Built from the word list on first use unless one was loaded from file.
+    const CompactDictionary &compactDictionary() const {
+        if (compactDictionaryStale) {
+            MemoryScope scope(MemorySubsystem::DICTIONARY);
+            compactDictionaryIndex.build(words);
+            compactDictionaryStale = false;
+        }
+        return compactDictionaryIndex;
+    }
+
+    // List words the loaded DAWG also holds are reported once, from the DAWG.
+    bool shadowedByCompactDictionary(const string &word) const {
+        return compactDictionaryLoaded && compactDictionaryIndex.contains(word);
+    }
+
+    template <class Visitor>
+    void forEachAnagram(const string &letters, Visitor &&visit) const {
+        LetterSignature signature = LetterSignature::of(letters);
+        auto it = anagramIndex.find(signature);
+        if (it != anagramIndex.end()) {
+            for (uint32_t index : it->second) {
+                if ((!signature.saturated() || sameLetters(words[index], letters)) && !shadowedByCompactDictionary(words[index])) {
+                    visit(words[index]);
+                }
+            }
+        }
+        if (compactDictionaryLoaded) {
+            compactDictionaryIndex.forEachSpelledFrom(letters, true, visit);
+        }
+    }
+
+    template <class Visitor>
+    void forEachBuildableWord(const string &letters, Visitor &&visit) const {
+        wordBuilder().forEachBuildable(letters, [&](uint32_t index) {
+            if (!shadowedByCompactDictionary(words[index])) {
+                visit(words[index]);
+            }
+        });
+        if (compactDictionaryLoaded) {
+            compactDictionaryIndex.forEachSpelledFrom(letters, false, visit);
+        }
+    }
+
+    // A different spelling of the answer's letters that is itself a dictionary
+    // word; the caller has already matched the letter signatures.
+    bool isDictionaryAnagram(const string &guess, const LetterSignature &guessSignature) const {
+        if (!uniqueWords.contains(guess, words) && !(compactDictionaryLoaded && compactDictionaryIndex.contains(guess))) {
+            return false;
+        }
+        return !guessSignature.saturated() || sameLetters(guess, currentWord);
+    }
+
+    static int64_t epochSeconds() {
+        return duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+    }
+
+    const LeaderboardStore::RankedView &windowView(LeaderboardWindow window, int64_t at) const {
+        static const LeaderboardStore::RankedView unavailable;
+        return leaderboardWindowsAvailable() ? leaderboard.windowView(window, at) : unavailable;
+    }
+
+    void printLeaderboard(const LeaderboardStore::RankedView &view, size_t offset, size_t limit) const {
+        WS_TRACE_SPAN("WordScrambleGame::displayLeaderboard");
+        string rendered;
+        renderView(rendered, view, offset, limit);
+        cout.write(rendered.data(), static_cast<streamsize>(rendered.size()));
+        cout.flush();
+    }
+
+    void renderView(string &out, const LeaderboardStore::RankedView &view, size_t offset, size_t limit) const {
+        out.clear();
+        if (view.slots.empty()) {
+            out.append("No leaderboard data available.\n");
+            return;
+        }
+        size_t rows = min(limit, view.slots.size() - min(offset, view.slots.size()));
+        out.reserve((rows + 1) * LeaderboardRenderer::kRowEstimate);
+        LeaderboardRenderer::appendHeader(out);
+        leaderboard.forEachInRange(view, offset, limit, [&](const LeaderboardEntry &entry, size_t rank) {
+            LeaderboardRenderer::appendRow(out, entry, rank);
+        });
+    }
+
+    vector<LeaderboardEntry> pageOf(const LeaderboardStore::RankedView &view, size_t offset, size_t limit) const {
+        WS_TRACE_SPAN("WordScrambleGame::leaderboardPage");
+        vector<LeaderboardEntry> page;
+        page.reserve(min(limit, view.slots.size() - min(offset, view.slots.size())));
+        leaderboard.forEachInRange(view, offset, limit, [&](const LeaderboardEntry &entry, size_t rank) {
+            page.push_back(entry);
+            page.back().rank = static_cast<int>(rank);
+        });
+        return page;
+    }
+
+    vector<LeaderboardEntry> aroundOf(const LeaderboardStore::RankedView &view, const string &name, size_t radius) const {
+        size_t rank = leaderboard.rankOf(name, view);
+        if (rank == 0) {
+            return {};
+        }
+        size_t first = rank - 1 > radius ? rank - 1 - radius : 0;
+        return pageOf(view, first, rank - first + radius);
+    }
+
+    // Without allocation hooks this is an estimate covering capacity slack,
+    // hash buckets and per-node overhead; it is kept O(1) so addWord() stays cheap.
+    void updateMemoryUsage() {
+        if (MemoryTracker::enabled()) {
+            const MemoryTracker &tracker = MemoryTracker::instance();
+            for (size_t i = 0; i < kMemorySubsystemCount; ++i) {
+                metrics.liveBytesBySubsystem[i] = tracker.liveBytes(static_cast<MemorySubsystem>(i));
+                metrics.peakBytesBySubsystem[i] = tracker.peakBytes(static_cast<MemorySubsystem>(i));
+            }
+            metrics.totalMemoryAllocated = tracker.totalLiveBytes();
+            metrics.peakMemoryUsage = max(metrics.peakMemoryUsage, tracker.totalPeakBytes());
+            return;
         }
-        total += playerName.size();
+        size_t dictionary = words.capacity() * sizeof(string) + dictionaryHeapBytes + uniqueWords.memoryBytes()
+                            + anagramIndex.bucket_count() * sizeof(void *) + compactDictionaryIndex.memoryBytes() + dedupFilter.memoryBytes();
+        size_t board = leaderboard.memoryBytes();
+        size_t session = stringHeapBytes(playerName) + stringHeapBytes(currentWord);
+        size_t values[kMemorySubsystemCount] = {dictionary, board, session, 0};
+        for (size_t i = 0; i < kMemorySubsystemCount; ++i) {
+            metrics.liveBytesBySubsystem[i] = values[i];
+            metrics.peakBytesBySubsystem[i] = max(metrics.peakBytesBySubsystem[i], values[i]);
+        }
+        size_t total = dictionary + board + session;
         metrics.totalMemoryAllocated = total;
         metrics.peakMemoryUsage = max(metrics.peakMemoryUsage, total);
     }
@@ -477,23 +4346,70 @@ private:
     }
 
     static string difficultyToString(Difficulty diff) {
-        switch (diff) {
-        case Difficulty::EASY:
-            return "Easy";
-        case Difficulty::MEDIUM:
-            return "Medium";
-        case Difficulty::HARD:
-            return "Hard";
-        }
-        return "Easy";
+        return difficultyLabel(diff);
     }
 
     size_t nextUnrevealedPosition() const {
-        for (size_t i = 0; i < currentWord.size(); ++i) {
-            if (revealedPositions.count(i) == 0) {
-                return i;
+        size_t position = countTrailingOnes(revealedMask);
+        return position < min(currentWord.size(), kMaxRevealablePositions) ? position : currentWord.size();
+    }
+
+    static bool isVowel(char ch) {
+        switch (::tolower(static_cast<unsigned char>(ch))) {
+        case 'a':
+        case 'e':
+        case 'i':
+        case 'o':
+        case 'u':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    template <class Predicate>
+    uint64_t letterPositions(uint64_t hidden, Predicate &&matches) const {
+        uint64_t positions = 0;
+        for (uint64_t remaining = hidden; remaining != 0; remaining &= remaining - 1) {
+            unsigned position = countTrailingZeros(remaining);
+            if (matches(currentWord[position])) {
+                positions |= uint64_t{1} << position;
+            }
+        }
+        return positions;
+    }
+
+    // English letter frequencies in hundredths of a percent.
+    static unsigned letterFrequency(char ch) {
+        static const unsigned frequencies[26] = {817, 149, 278, 425, 1270, 223, 202, 609, 697, 15, 77, 403, 241,
+                                                 675, 751, 193, 10, 599, 633, 906, 276, 98, 236, 15, 197, 7};
+        unsigned letter = static_cast<unsigned>(::tolower(static_cast<unsigned char>(ch)) - 'a');
+        return letter < 26 ? frequencies[letter] : 0;
+    }
+
+    size_t rarestHiddenPosition(uint64_t hidden) const {
+        size_t best = countTrailingZeros(hidden);
+        for (uint64_t remaining = hidden; remaining != 0; remaining &= remaining - 1) {
+            unsigned position = countTrailingZeros(remaining);
+            if (letterFrequency(currentWord[position]) < letterFrequency(currentWord[best])) {
+                best = position;
+            }
+        }
+        return best;
+    }
+
+    size_t mostRepeatedHiddenPosition(uint64_t hidden) const {
+        array<uint8_t, 26> counts{};
+        size_t best = countTrailingZeros(hidden);
+        unsigned bestCount = 0;
+        for (uint64_t remaining = hidden; remaining != 0; remaining &= remaining - 1) {
+            unsigned position = countTrailingZeros(remaining);
+            unsigned letter = static_cast<unsigned>(::tolower(static_cast<unsigned char>(currentWord[position])) - 'a');
+            if (letter < 26 && ++counts[letter] > bestCount) {
+                bestCount = counts[letter];
+                best = position;
             }
         }
-        return currentWord.size();
+        return best;
     }
 };
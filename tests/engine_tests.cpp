@@ -0,0 +1,1371 @@
+// Regression checks for the engine. Allocation tracking, tracing and the TSC
+// clock are always compiled in here so the MemoryTracker hooks, the trace spans
+// and the x86 timing path are exercised too.
+//
+//   g++ -std=c++17 -O2 -pthread -o engine_tests tests/engine_tests.cpp
+//   ./engine_tests
+//
+// Each check prints its name and failures; the exit status is the failure count.
+
+#ifndef WORDSCRAMBLE_TRACK_ALLOCATIONS
+#define WORDSCRAMBLE_TRACK_ALLOCATIONS
+#endif
+#ifndef WORDSCRAMBLE_USE_TSC
+#define WORDSCRAMBLE_USE_TSC
+#endif
+#ifndef WORDSCRAMBLE_ENABLE_TRACING
+#define WORDSCRAMBLE_ENABLE_TRACING
+#endif
+#include "../cgpa_calculator.cpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <numeric>
+#include <set>
+
+namespace {
+
+int failures = 0;
+
+#define EXPECT(condition)                                                              \
+    do {                                                                               \
+        if (!(condition)) {                                                            \
+            std::printf("  %s:%d: expected %s\n", __FILE__, __LINE__, #condition);     \
+            ++failures;                                                                \
+        }                                                                              \
+    } while (0)
+
+string scratchPath(const string &name) {
+    static const filesystem::path directory = [] {
+        filesystem::path path = filesystem::temp_directory_path() / "wordscramble_tests";
+        filesystem::create_directories(path);
+        return path;
+    }();
+    return (directory / name).string();
+}
+
+string readFile(const string &path) {
+    ifstream input(path, ios::binary);
+    stringstream contents;
+    contents << input.rdbuf();
+    return contents.str();
+}
+
+void writeFile(const string &path, const string &contents) {
+    ofstream output(path, ios::binary);
+    output << contents;
+}
+
+// Below 32 every value has its own bucket; above, a percentile lands in the
+// bucket holding the target rank and is at most ~3% high.
+void testLatencyHistogramPercentiles() {
+    LatencyHistogram small;
+    for (uint64_t value = 0; value < 20; ++value) {
+        small.record(value);
+    }
+    EXPECT(small.percentile(50.0) == 9);
+    EXPECT(small.percentile(0.0) == 0);
+    EXPECT(small.percentile(100.0) == 19);
+
+    LatencyHistogram low;
+    LatencyHistogram high;
+    for (uint64_t value = 1; value <= 100000; ++value) {
+        (value % 2 == 0 ? low : high).record(value * 1000);
+    }
+    low.merge(high);
+    EXPECT(low.count() == 100000);
+    EXPECT(low.min() == 1000 && low.max() == 100000000);
+    for (double percent : {50.0, 90.0, 99.0, 99.9}) {
+        double exact = percent / 100.0 * 100000000.0;
+        double reported = static_cast<double>(low.percentile(percent));
+        EXPECT(reported >= exact && reported <= exact * 1.035);
+    }
+    EXPECT(low.percentile(100.0) == 100000000);
+    EXPECT(LatencyHistogram{}.percentile(50.0) == 0);
+}
+
+void testFormatDurationUnits() {
+    EXPECT(formatDuration(0) == "0 ns");
+    EXPECT(formatDuration(999) == "999 ns");
+    EXPECT(formatDuration(1000) == "1.00 us");
+    EXPECT(formatDuration(123456) == "123.46 us");
+    EXPECT(formatDuration(1000000) == "1.00 ms");
+    EXPECT(formatDuration(1500000) == "1.50 ms");
+    EXPECT(formatDuration(1000000000) == "1.00 s");
+    EXPECT(formatDuration(90000000000) == "90.00 s");
+}
+
+void testMetricsClock() {
+#ifdef WORDSCRAMBLE_HAS_TSC
+    const uint64_t base = uint64_t(1) << 40;
+    const uint64_t unitScale = uint64_t(1) << 32;
+    EXPECT(MetricsClock::tscToNanoseconds(base + 1000, base, unitScale) == 1000);
+    EXPECT(MetricsClock::tscToNanoseconds(base + 1000, base, unitScale / 4) == 250);
+    // A lagging core's TSC must not wrap around to centuries.
+    EXPECT(MetricsClock::tscToNanoseconds(base - 5, base, unitScale) == 0);
+#endif
+    uint64_t start = MetricsClock::now();
+    this_thread::sleep_for(milliseconds(2));
+    uint64_t waited = MetricsClock::elapsed(start, MetricsClock::now());
+    EXPECT(waited >= 1000000 && waited < 2000000000);
+    EXPECT(MetricsClock::elapsed(start + 10, start) == 0);
+}
+
+// Minimal JSON reader for checking exports: validates the grammar and records
+// every string and number leaf under its dotted key path (array items by index).
+struct JsonReader {
+    explicit JsonReader(string_view json) : text(json) {}
+
+    string_view text;
+    size_t pos{0};
+    map<string, string> strings;
+    map<string, double> numbers;
+
+    bool parse() {
+        return value("") && (skipSpace(), pos == text.size());
+    }
+
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\t' || text[pos] == '\r')) {
+            ++pos;
+        }
+    }
+
+    bool consume(char ch) {
+        skipSpace();
+        if (pos < text.size() && text[pos] == ch) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool value(const string &path) {
+        skipSpace();
+        if (pos >= text.size()) {
+            return false;
+        }
+        if (text[pos] == '{') {
+            ++pos;
+            if (consume('}')) {
+                return true;
+            }
+            do {
+                string key;
+                skipSpace();
+                if (!stringValue(key) || !consume(':') || !value(path.empty() ? key : path + "." + key)) {
+                    return false;
+                }
+            } while (consume(','));
+            return consume('}');
+        }
+        if (text[pos] == '[') {
+            ++pos;
+            if (consume(']')) {
+                return true;
+            }
+            size_t index = 0;
+            do {
+                if (!value(path + "." + to_string(index++))) {
+                    return false;
+                }
+            } while (consume(','));
+            return consume(']');
+        }
+        if (text[pos] == '"') {
+            string decoded;
+            if (!stringValue(decoded)) {
+                return false;
+            }
+            strings[path] = decoded;
+            return true;
+        }
+        static const regex number(R"(^-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][-+]?[0-9]+)?)");
+        match_results<string_view::const_iterator> found;
+        if (!regex_search(text.begin() + static_cast<ptrdiff_t>(pos), text.end(), found, number)) {
+            return false;
+        }
+        numbers[path] = stod(found.str());
+        pos += static_cast<size_t>(found.length());
+        return true;
+    }
+
+    bool stringValue(string &decoded) {
+        if (pos >= text.size() || text[pos++] != '"') {
+            return false;
+        }
+        while (pos < text.size() && text[pos] != '"') {
+            char ch = text[pos++];
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                return false;
+            }
+            if (ch != '\\') {
+                decoded.push_back(ch);
+                continue;
+            }
+            if (pos >= text.size()) {
+                return false;
+            }
+            char escape = text[pos++];
+            if (escape == 'u') {
+                if (pos + 4 > text.size()) {
+                    return false;
+                }
+                unsigned code = static_cast<unsigned>(stoul(string(text.substr(pos, 4)), nullptr, 16));
+                pos += 4;
+                decoded.push_back(static_cast<char>(code));
+            } else if (escape == 'n') {
+                decoded.push_back('\n');
+            } else if (escape == '"' || escape == '\\' || escape == '/') {
+                decoded.push_back(escape);
+            } else {
+                return false;
+            }
+        }
+        return pos++ < text.size();
+    }
+};
+
+// Known counters and a known guess-latency histogram, merged in so both
+// exports have exact values to check.
+WordScrambleGame gameWithKnownMetrics(const string &player) {
+    WordScrambleGame game;
+    game.setPlayerName(player);
+    Metrics known;
+    known.guessCount = 3;
+    known.scrambleCount = 5;
+    known.bytesRead = 4096;
+    for (uint64_t nanoseconds : {1000, 2000, 3000}) {
+        known.guessLatency.record(nanoseconds);
+    }
+    game.mergeMetrics(known);
+    return game;
+}
+
+void testPrometheusExportSyntax() {
+    WordScrambleGame game = gameWithKnownMetrics("alice");
+    string out;
+    game.exportMetrics(out, MetricsFormat::PROMETHEUS);
+    static const regex comment(R"(# (HELP|TYPE) wordscramble_[a-z_]+ .+)");
+    static const regex type(R"(# TYPE (wordscramble_[a-z_]+) (counter|gauge|summary))");
+    static const regex sample(
+        R"(([a-zA-Z_:][a-zA-Z0-9_:]*)(\{[a-zA-Z_][a-zA-Z0-9_]*="[^"]*"(,[a-zA-Z_][a-zA-Z0-9_]*="[^"]*")*\})? (-?[0-9]+(\.[0-9]+)?([eE][-+]?[0-9]+)?))");
+    EXPECT(!out.empty() && out.back() == '\n');
+    set<string> typed;
+    map<string, double> samples;
+    istringstream lines(out);
+    string line;
+    while (getline(lines, line)) {
+        smatch parts;
+        if (line.rfind("#", 0) == 0) {
+            EXPECT(regex_match(line, comment));
+            if (regex_match(line, parts, type)) {
+                typed.insert(parts[1]);
+            }
+            continue;
+        }
+        bool valid = regex_match(line, parts, sample);
+        EXPECT(valid);
+        if (!valid) {
+            continue;
+        }
+        string family = parts[1];
+        for (const char *suffix : {"_sum", "_count"}) {
+            size_t length = strlen(suffix);
+            if (family.size() > length && family.compare(family.size() - length, length, suffix) == 0 && !typed.count(family)) {
+                family.erase(family.size() - length);
+            }
+        }
+        EXPECT(typed.count(family) == 1);
+        samples[string(parts[1]) + string(parts[2])] = stod(parts[4]);
+    }
+    EXPECT(samples["wordscramble_guesses_total"] == 3);
+    EXPECT(samples["wordscramble_scrambles_total"] == 5);
+    EXPECT(samples["wordscramble_file_read_bytes_total"] == 4096);
+    EXPECT(samples["wordscramble_guess_latency_seconds_count"] == 3);
+    EXPECT(fabs(samples["wordscramble_guess_latency_seconds_sum"] - 6e-6) < 1e-12);
+    for (const char *quantile : {"0.5", "0.9", "0.99", "0.999"}) {
+        EXPECT(samples.count(string("wordscramble_guess_latency_seconds{quantile=\"") + quantile + "\"}") == 1);
+    }
+    double median = samples["wordscramble_guess_latency_seconds{quantile=\"0.5\"}"];
+    EXPECT(median >= 2e-6 && median <= 2e-6 * 1.035);
+    EXPECT(samples["wordscramble_file_io_latency_seconds_count"] == 0);
+}
+
+void testJsonExportRoundTrips() {
+    const string player = "O'Neil \"the \\ quote\"\n\t";
+    WordScrambleGame game = gameWithKnownMetrics(player);
+    string out;
+    game.exportMetrics(out, MetricsFormat::JSON);
+    JsonReader reader(out);
+    EXPECT(reader.parse());
+    EXPECT(reader.strings["player"] == player);
+    EXPECT(reader.numbers["guesses"] == 3);
+    EXPECT(reader.numbers["scrambles"] == 5);
+    EXPECT(reader.numbers["bytes_read"] == 4096);
+    EXPECT(reader.numbers["latency.guess.count"] == 3);
+    EXPECT(reader.numbers["latency.guess.sum_ns"] == 6000);
+    EXPECT(reader.numbers["latency.guess.min_ns"] == 1000);
+    EXPECT(reader.numbers["latency.guess.max_ns"] == 3000);
+    EXPECT(reader.numbers.count("rates.uptime_seconds") == 1);
+    EXPECT(reader.numbers.count("memory_by_subsystem.leaderboard.live_bytes") == 1);
+
+    // The buffer is rebuilt, not appended to, on each export.
+    string again = out;
+    game.exportMetrics(again, MetricsFormat::JSON);
+    EXPECT(JsonReader(again).parse());
+}
+
+void testMetricsBufferClampsNonFinite() {
+    string out;
+    MetricsBuffer buffer(out);
+    buffer.append(numeric_limits<double>::quiet_NaN()).append(' ').append(numeric_limits<double>::infinity()).append(' ')
+        .append(-numeric_limits<double>::infinity()).append(' ').append(0.25);
+    EXPECT(out == "0 0 0 0.25");
+}
+
+void testChromeTraceShape() {
+    TraceRecorder &recorder = TraceRecorder::instance();
+    recorder.clear();
+    WordScrambleGame game;
+    game.addWord("tracing");
+    game.selectRandomWord();
+    game.checkGuess("nope");
+    EXPECT(game.saveLeaderboardToFile(scratchPath("trace_leaderboard.csv")));
+    EXPECT(recorder.eventCount() >= 4);
+    string path = scratchPath("trace.json");
+    EXPECT(WordScrambleGame::saveTraceToFile(path));
+    string json = readFile(path);
+    JsonReader reader(json);
+    EXPECT(reader.parse());
+    EXPECT(reader.strings["displayTimeUnit"] == "ns");
+    EXPECT(reader.strings["traceEvents.0.ph"] == "X");
+    const string head = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    EXPECT(json.compare(0, head.size(), head) == 0);
+    EXPECT(json.size() >= 4 && json.compare(json.size() - 4, 4, "\n]}\n") == 0);
+    static const regex event(
+        R"re(\{"name":"([A-Za-z:]+)","cat":"engine","ph":"X","pid":1,"tid":[1-9][0-9]*,"ts":[0-9]+\.[0-9]{3},"dur":[0-9]+\.[0-9]{3}\},?)re");
+    set<string> names;
+    size_t events = 0;
+    istringstream lines(json.substr(head.size(), json.size() - head.size() - 4));
+    string line;
+    while (getline(lines, line)) {
+        smatch parts;
+        bool valid = regex_match(line, parts, event);
+        EXPECT(valid);
+        if (valid) {
+            names.insert(parts[1]);
+            ++events;
+        }
+    }
+    EXPECT(events == recorder.eventCount());
+    for (const char *name : {"WordScrambleGame::addWord", "WordScrambleGame::selectRandomWord", "WordScrambleGame::checkGuess",
+                             "WordScrambleGame::saveLeaderboardToFile"}) {
+        EXPECT(names.count(name) == 1);
+    }
+    recorder.clear();
+    EXPECT(recorder.eventCount() == 0);
+}
+
+// A full ring overwrites its oldest spans instead of growing.
+void testTraceBufferIsBounded() {
+    TraceRecorder &recorder = TraceRecorder::instance();
+    recorder.clear();
+    for (size_t i = 0; i < TraceRecorder::kMaxEventsPerThread + 10; ++i) {
+        recorder.record("bounded", i, 1);
+    }
+    EXPECT(recorder.eventCount() == TraceRecorder::kMaxEventsPerThread);
+    EXPECT(recorder.droppedCount() == 10);
+    recorder.clear();
+    EXPECT(recorder.eventCount() == 0 && recorder.droppedCount() == 0);
+}
+
+void testAlignedAllocationsAreTracked() {
+    MemoryTracker &tracker = MemoryTracker::instance();
+    size_t before = tracker.liveBytes(MemorySubsystem::SESSION);
+    {
+        MemoryScope scope(MemorySubsystem::SESSION);
+        BlockedBloomFilter filter;
+        filter.reset(4096);
+        EXPECT(tracker.liveBytes(MemorySubsystem::SESSION) >= before + filter.memoryBytes());
+        auto *block = new (align_val_t(256)) char[100];
+        EXPECT(reinterpret_cast<uintptr_t>(block) % 256 == 0);
+        operator delete[](block, align_val_t(256));
+    }
+    EXPECT(tracker.liveBytes(MemorySubsystem::SESSION) == before);
+}
+
+// 12 bits per key and 6 probes per 512-bit block should stay near 0.45%.
+void testBloomFilterFalsePositiveRate() {
+    for (size_t keys : {size_t(10000), size_t(200000)}) {
+        BlockedBloomFilter filter;
+        filter.reset(keys);
+        for (size_t i = 0; i < keys; ++i) {
+            filter.insert(caseInsensitiveHash("word" + to_string(i)));
+        }
+        bool allFound = true;
+        for (size_t i = 0; i < keys; ++i) {
+            allFound = allFound && filter.mayContain(caseInsensitiveHash("word" + to_string(i)));
+        }
+        EXPECT(allFound);
+        size_t queries = 200000;
+        size_t falsePositives = 0;
+        for (size_t i = 0; i < queries; ++i) {
+            falsePositives += filter.mayContain(caseInsensitiveHash("miss" + to_string(i))) ? 1 : 0;
+        }
+        EXPECT(static_cast<double>(falsePositives) / static_cast<double>(queries) < 0.006);
+    }
+}
+
+// The filter only skips hash-set lookups; addWord must accept and reject the
+// same words with it as without, including across filter resizes.
+void testDedupFilterMatchesUnfilteredAddWord() {
+    WordScrambleGame plain;
+    WordScrambleGame filtered;
+    filtered.enableDedupFilter(64);
+    mt19937 rng(3);
+    bool same = true;
+    for (int i = 0; i < 20000; ++i) {
+        string word = rng() % 4 == 0 ? "W" : "w";
+        unsigned n = rng() % 8000;
+        do {
+            word += static_cast<char>('a' + n % 26);
+            n /= 26;
+        } while (n > 0);
+        if (i == 15000) {
+            filtered.disableDedupFilter();
+        }
+        same = same && plain.addWord(word) == filtered.addWord(word);
+    }
+    EXPECT(same);
+    EXPECT(plain.getWordList() == filtered.getWordList());
+    const Metrics &metrics = filtered.getMetrics();
+    EXPECT(metrics.dedupFilterQueries == 15000);
+    EXPECT(metrics.dedupFilterRejections > 0);
+}
+
+void testMultiplyHigh() {
+    EXPECT(multiplyHigh(UINT64_MAX, UINT64_MAX) == UINT64_MAX - 1);
+    EXPECT(multiplyHigh(uint64_t(1) << 63, 4) == 2);
+    EXPECT(multiplyHigh(0x123456789ABCDEF0ULL, 1000) == 71);
+}
+
+// Words of 2..8 letters over a six-letter alphabet, so most share letters.
+vector<string> randomWords(size_t count, unsigned seed) {
+    mt19937 rng(seed);
+    vector<string> words;
+    for (size_t i = 0; i < count; ++i) {
+        string word(2 + rng() % 7, 'a');
+        for (char &ch : word) {
+            ch = static_cast<char>((rng() % 3 == 0 ? 'A' : 'a') + rng() % 6);
+        }
+        words.push_back(word);
+    }
+    return words;
+}
+
+array<int, 26> letterCounts(const string &word) {
+    array<int, 26> counts{};
+    for (char ch : word) {
+        counts[static_cast<size_t>(::tolower(static_cast<unsigned char>(ch)) - 'a')]++;
+    }
+    return counts;
+}
+
+void testAnagramIndexMatchesBruteForce() {
+    WordScrambleGame game;
+    for (const string &word : randomWords(3000, 11)) {
+        game.addWord(word);
+    }
+    for (const string &query : randomWords(300, 12)) {
+        vector<string> expected;
+        for (const string &word : game.getWordList()) {
+            if (letterCounts(word) == letterCounts(query)) {
+                expected.push_back(word);
+            }
+        }
+        vector<string> found = game.findAnagrams(query);
+        sort(found.begin(), found.end());
+        sort(expected.begin(), expected.end());
+        EXPECT(found == expected);
+        EXPECT(game.countSolutions(query) == expected.size());
+    }
+    EXPECT(game.countSolutions("ZZLEPU") == 1);
+}
+
+void testLetterSignature() {
+    EXPECT(LetterSignature::of("Listen") == LetterSignature::of("SILENT"));
+    EXPECT(LetterSignature::of("listen") != LetterSignature::of("listens"));
+    EXPECT(LetterSignature::of("aab") != LetterSignature::of("abb"));
+    EXPECT(LetterSignature::of("zyx").count(25) == 1 && LetterSignature::of("zyx").length() == 3);
+    EXPECT(!LetterSignature::of("no-dash").valid());
+    EXPECT(!LetterSignature::of(string(LetterSignature::kMaxLength + 1, 'a')).valid());
+    // Counts stop at 15, so two saturated letters can collide; callers compare letters then.
+    LetterSignature left = LetterSignature::of(string(16, 'a') + string(16, 'b'));
+    LetterSignature right = LetterSignature::of(string(17, 'a') + string(15, 'b'));
+    EXPECT(left.saturated() && right.saturated());
+    EXPECT(left == right);
+    EXPECT(!LetterSignature::of(string(15, 'a')).saturated());
+}
+
+bool buildableFrom(const string &word, const string &letters) {
+    array<int, 26> have = letterCounts(letters);
+    array<int, 26> need = letterCounts(word);
+    return equal(need.begin(), need.end(), have.begin(), [](int needed, int held) {
+        return needed <= held;
+    });
+}
+
+void testWordBuilderMatchesBruteForce() {
+    WordScrambleGame game;
+    for (const string &word : randomWords(3000, 21)) {
+        game.addWord(word);
+    }
+    for (const string &query : randomWords(200, 22)) {
+        vector<string> expected;
+        for (const string &word : game.getWordList()) {
+            if (word.size() >= 3 && buildableFrom(word, query)) {
+                expected.push_back(word);
+            }
+        }
+        vector<string> found = game.findBuildableWords(query, 3);
+        sort(found.begin(), found.end());
+        sort(expected.begin(), expected.end());
+        EXPECT(found == expected);
+    }
+    // Adding a word after a query rebuilds the index.
+    size_t before = game.countBuildableWords("qqxx");
+    EXPECT(game.addWord("qqx"));
+    EXPECT(game.countBuildableWords("qqxx") == before + 1);
+}
+
+// Lookups fold case and keep finding every word as the table grows past 7/8 full.
+void testFlatWordSetMatchesStdSet() {
+    FlatWordSet flat;
+    vector<string> storage;
+    set<string> reference;
+    for (const string &word : randomWords(20000, 31)) {
+        string lowered = WordScrambleGame::toLowerCase(word);
+        EXPECT(flat.contains(word, storage) == (reference.count(lowered) != 0));
+        if (reference.insert(lowered).second) {
+            storage.push_back(word);
+            flat.insertNew(static_cast<uint32_t>(storage.size() - 1), caseInsensitiveHash(word));
+        }
+        EXPECT(flat.size() * 8 <= flat.capacity() * 7);
+    }
+    EXPECT(flat.size() == reference.size());
+    for (const string &word : reference) {
+        string upper = word;
+        transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char ch) {
+            return static_cast<char>(::toupper(ch));
+        });
+        EXPECT(flat.contains(upper, storage));
+    }
+    EXPECT(!flat.contains("ghij", storage));
+    EXPECT(!FlatWordSet{}.contains("abc", storage));
+}
+
+// Magic plus a header claiming `nodes` nodes and `edges` edges, and no body.
+string dawgHeaderOnly(uint32_t nodes, uint32_t edges) {
+    string contents = "WSDAWG1\n";
+    uint32_t header[3] = {nodes, edges, 1};
+    contents.append(reinterpret_cast<const char *>(header), sizeof(header));
+    return contents;
+}
+
+void testCorruptCompactDictionaryIsRejected() {
+    WordScrambleGame source;
+    source.addWord("listen");
+    string valid = scratchPath("valid.dawg");
+    EXPECT(source.saveCompactDictionary(valid));
+    string bytes = readFile(valid);
+
+    string path = scratchPath("corrupt.dawg");
+    WordScrambleGame game;
+    writeFile(path, dawgHeaderOnly(0xFFFFFFFFu, 0xFFFFFFFFu));
+    EXPECT(!game.loadCompactDictionaryFromFile(path));
+    writeFile(path, dawgHeaderOnly(100000000u, 0));
+    EXPECT(!game.loadCompactDictionaryFromFile(path));
+    writeFile(path, bytes.substr(0, bytes.size() / 2));
+    EXPECT(!game.loadCompactDictionaryFromFile(path));
+    writeFile(path, bytes.substr(0, 10));
+    EXPECT(!game.loadCompactDictionaryFromFile(path));
+    EXPECT(game.countWordsWithPrefix("list") == 0);
+
+    EXPECT(game.loadCompactDictionaryFromFile(valid));
+    EXPECT(game.countWordsWithPrefix("list") == 1);
+}
+
+// A single chain of `length` 'a' edges ending in a final node.
+string dawgChain(uint32_t length) {
+    uint32_t nodes = length + 1;
+    string contents = "WSDAWG1\n";
+    uint32_t header[3] = {nodes, length, 1};
+    contents.append(reinterpret_cast<const char *>(header), sizeof(header));
+    vector<uint32_t> firstEdge(nodes + 1);
+    vector<uint32_t> edges(length);
+    for (uint32_t node = 0; node < nodes; ++node) {
+        firstEdge[node + 1] = firstEdge[node] + (node < length ? 1 : 0);
+        if (node < length) {
+            edges[node] = (node + 1) << 5;
+        }
+    }
+    vector<uint8_t> isFinal(nodes, 0);
+    isFinal.back() = 1;
+    contents.append(reinterpret_cast<const char *>(firstEdge.data()), firstEdge.size() * sizeof(uint32_t));
+    contents.append(reinterpret_cast<const char *>(edges.data()), edges.size() * sizeof(uint32_t));
+    contents.append(reinterpret_cast<const char *>(isFinal.data()), isFinal.size());
+    return contents;
+}
+
+void testCompactDictionaryCapsWordLength() {
+    string path = scratchPath("chain.dawg");
+    WordScrambleGame game;
+    writeFile(path, dawgChain(static_cast<uint32_t>(kMaxWordLength)));
+    EXPECT(game.loadCompactDictionaryFromFile(path));
+    EXPECT(game.wordsWithPrefix("", 1) == vector<string>{string(kMaxWordLength, 'a')});
+    writeFile(path, dawgChain(static_cast<uint32_t>(kMaxWordLength) + 1));
+    EXPECT(!game.loadCompactDictionaryFromFile(path));
+    writeFile(path, dawgChain(200000));
+    EXPECT(!game.loadCompactDictionaryFromFile(path));
+
+    CompactDictionary dictionary;
+    dictionary.build({string(kMaxWordLength + 1, 'b'), "cab", "ab", "abc", "b"});
+    EXPECT(dictionary.size() == 3);
+    EXPECT(dictionary.wordsWithPrefix("", 10) == (vector<string>{"ab", "abc", "cab"}));
+    EXPECT(dictionary.wordsWithPrefix("a", 1) == vector<string>{"ab"});
+    EXPECT(dictionary.wordsWithPrefix("", 2) == (vector<string>{"ab", "abc"}));
+}
+
+void testCompactDictionarySkipsShortWords() {
+    CompactDictionary dictionary;
+    dictionary.build({"", "a", "B", "ab", "ba"});
+    EXPECT(dictionary.size() == 2);
+    EXPECT(!dictionary.contains("a"));
+    EXPECT(!dictionary.contains("b"));
+    EXPECT(dictionary.wordsWithPrefix("", 10) == (vector<string>{"ab", "ba"}));
+
+    string path = scratchPath("short.dawg");
+    WordScrambleGame game;
+    writeFile(path, dawgChain(static_cast<uint32_t>(kMinWordLength)));
+    EXPECT(game.loadCompactDictionaryFromFile(path));
+    writeFile(path, dawgChain(1));
+    EXPECT(!game.loadCompactDictionaryFromFile(path));
+    writeFile(path, dawgChain(0));
+    EXPECT(!game.loadCompactDictionaryFromFile(path));
+    EXPECT(game.countWordsWithPrefix("") == 1);
+}
+
+void testCompactDictionaryAnswersAnagramQueries() {
+    WordScrambleGame source;
+    for (const char *word : {"listen", "silent", "enlist", "tinsel", "list", "puzzle"}) {
+        source.addWord(word);
+    }
+    string path = scratchPath("anagrams.dawg");
+    uint64_t written = source.getMetrics().bytesWritten;
+    EXPECT(source.saveCompactDictionary(path));
+    EXPECT(source.getMetrics().bytesWritten - written == filesystem::file_size(path));
+
+    WordScrambleGame game;
+    EXPECT(game.countSolutions("tslien") == 0);
+    uint64_t read = game.getMetrics().bytesRead;
+    EXPECT(game.loadCompactDictionaryFromFile(path));
+    EXPECT(game.getMetrics().bytesRead - read == filesystem::file_size(path));
+    EXPECT(game.countSolutions("tslien") == 4);
+    EXPECT(game.findAnagrams("NETSIL").size() == 4);
+    // "puzzle" is both a default word and in the DAWG; it counts once.
+    EXPECT(game.countSolutions("zzpelu") == 1);
+    vector<string> buildable = game.findBuildableWords("listen", 4);
+    EXPECT(buildable.size() == 5);
+    EXPECT(find(buildable.begin(), buildable.end(), "list") != buildable.end());
+    EXPECT(game.countBuildableWords("elzzupx") == 1);
+}
+
+// Adds `word` and draws until it is the current word.
+void selectWord(WordScrambleGame &game, const string &word) {
+    game.addWord(word);
+    game.seedRandom(1);
+    while (game.selectRandomWord() != word) {
+    }
+}
+
+string revealedPattern(const WordScrambleGame &game) {
+    char buffer[kMaxWordLength + 1];
+    size_t length = game.revealedPattern(buffer, sizeof(buffer));
+    return string(buffer, length);
+}
+
+// NEXT_LETTER walks every position of the longest allowed word, one bit each.
+void testHintMaskCoversLongestWord() {
+    string word = "abcdefghijklmnopqrst";
+    EXPECT(word.size() == kMaxWordLength);
+    WordScrambleGame game;
+    selectWord(game, word);
+    EXPECT(revealedPattern(game) == string(word.size(), '_'));
+    for (size_t i = 0; i < word.size(); ++i) {
+        HintResult hint = game.requestHint(HintKind::NEXT_LETTER);
+        EXPECT(hint.status == HintStatus::REVEALED);
+        EXPECT(hint.revealedMask == uint64_t{1} << i);
+        EXPECT(hint.position == i && hint.letter == word[i]);
+        EXPECT(hint.remaining == word.size() - i - 1);
+    }
+    EXPECT(revealedPattern(game) == word);
+    EXPECT(game.requestHint(HintKind::NEXT_LETTER).status == HintStatus::EXHAUSTED);
+    game.selectRandomWord();
+    EXPECT(revealedPattern(game).find_first_not_of('_') == string::npos);
+}
+
+void testHintKindsReturnStructuredResults() {
+    WordScrambleGame game;
+    EXPECT(game.requestHint(HintKind::FIRST_LETTER).status == HintStatus::NO_WORD);
+    selectWord(game, "puzzle");
+
+    HintResult ends = game.requestHint(HintKind::FIRST_AND_LAST);
+    EXPECT(ends.status == HintStatus::REVEALED && ends.kind == HintKind::FIRST_AND_LAST);
+    EXPECT(ends.revealedMask == 0b100001 && ends.position == 5 && ends.letter == 'e' && ends.remaining == 4);
+    // Only hidden vowels count: 'e' is already shown.
+    HintResult vowels = game.requestHint(HintKind::VOWELS);
+    EXPECT(vowels.revealedMask == 0b10 && vowels.letter == 'u' && vowels.remaining == 3);
+    HintResult pattern = game.requestHint(HintKind::PATTERN);
+    EXPECT(pattern.revealedMask == 0b1100 && pattern.letter == 'z' && pattern.remaining == 1);
+    EXPECT(game.requestHint(HintKind::VOWELS).status == HintStatus::NOT_APPLICABLE);
+    HintResult rarest = game.requestHint(HintKind::RAREST_LETTER);
+    EXPECT(rarest.revealedMask == 0b10000 && rarest.letter == 'l' && rarest.remaining == 0);
+    EXPECT(revealedPattern(game) == "puzzle");
+    EXPECT(game.requestHint(HintKind::FIRST_LETTER).status == HintStatus::EXHAUSTED);
+
+    ostringstream printed;
+    game.printHint(printed, ends);
+    EXPECT(printed.str() == "Starts with p ... ends with e\n");
+}
+
+const char *kLeaderboardHeader = "RANK,NAME,SCORE,GAMES,ATTEMPTS,AVG_TIME,ACCURACY,AVG_GUESS_TIME,DIFFICULTY,PLAYED_AT\n";
+
+constexpr int64_t kDay = LeaderboardStore::kSecondsPerDay;
+constexpr int64_t kEpoch = 1767225600; // 2026-01-01, a Thursday.
+
+void testNonFiniteLeaderboardRowsAreSkipped() {
+    string path = scratchPath("nonfinite.csv");
+    writeFile(path, string(kLeaderboardHeader)
+                        + "1,alice,300,1,1,5.00,90.00,5.00,1,0\n"
+                        + "2,nanny,300,1,1,5.00,nan,5.00,1,0\n"
+                        + "3,bob,300,1,1,5.00,80.00,5.00,1,0\n"
+                        + "4,infy,250,1,1,inf,70.00,5.00,2,0\n"
+                        + "5,carol,200,1,1,5.00,60.00,5.00,1,0\n");
+    WordScrambleGame game;
+    EXPECT(game.loadLeaderboardFromFile(path));
+    EXPECT(game.leaderboardSize() == 3);
+    EXPECT(game.leaderboardRankOf("alice") == 1);
+    EXPECT(game.leaderboardRankOf("bob") == 2);
+    EXPECT(game.leaderboardRankOf("carol") == 3);
+    EXPECT(game.leaderboardRankOf("nanny") == 0);
+}
+
+// The write path refuses what the loader would skip, so every stored row
+// survives a save and reload.
+void testNonFiniteRoundTimeIsRejected() {
+    WordScrambleGame game;
+    game.setPlayerName("ann");
+    EXPECT(!game.updateLeaderboard(numeric_limits<double>::quiet_NaN(), kEpoch));
+    EXPECT(!game.updateLeaderboard(numeric_limits<double>::infinity(), kEpoch));
+    EXPECT(game.leaderboardSize() == 0);
+    EXPECT(game.updateLeaderboard(4.5, kEpoch));
+    string path = scratchPath("finite_round_trip.csv");
+    EXPECT(game.saveLeaderboardToFile(path));
+    WordScrambleGame reloaded;
+    EXPECT(reloaded.loadLeaderboardFromFile(path));
+    EXPECT(reloaded.leaderboardSize() == game.leaderboardSize());
+    LeaderboardEntry entry;
+    EXPECT(reloaded.findLeaderboardEntry("ann", entry) && entry.averageTime == 4.5 && entry.playedAt == kEpoch);
+}
+
+// The iostream formatting the buffered renderer replaced, row for row.
+string streamedRow(const LeaderboardEntry &entry) {
+    ostringstream row;
+    row << left << setw(5) << entry.rank << setw(15) << entry.name << setw(10) << entry.score << setw(10) << entry.games
+        << setw(12) << entry.attempts << setw(12) << fixed << setprecision(1) << entry.averageTime << setw(12)
+        << entry.accuracy << "%" << setw(15) << setprecision(2) << entry.averageGuessTime << setw(12)
+        << difficultyLabel(entry.difficulty) << '\n';
+    return row.str();
+}
+
+void testRenderedLeaderboardMatchesStreams() {
+    string path = scratchPath("render.csv");
+    writeFile(path, string(kLeaderboardHeader)
+                        + "1,alice,123456789,12,40,5.25,99.95,1.005,1,0\n"
+                        + "2,a_very_long_player_name,300,1,1,0.04,-0.00,0.00,3,0\n"
+                        + "3,bob,-20,0,0,12345.67,12.34,2.50,2,0\n");
+    WordScrambleGame game;
+    EXPECT(game.loadLeaderboardFromFile(path));
+    string expected = "Rank Name           Score     Games     Attempts    Avg Time    Accuracy    Avg Guess      Difficulty  \n";
+    for (const LeaderboardEntry &entry : game.leaderboardPage(1, 10)) {
+        expected += streamedRow(entry);
+    }
+    string rendered;
+    game.renderLeaderboard(rendered, 1, 10);
+    EXPECT(rendered == expected);
+    game.renderLeaderboard(rendered, 5, 10);
+    EXPECT(rendered.find('\n') == rendered.size() - 1);
+    WordScrambleGame empty;
+    empty.renderLeaderboard(rendered, 0, 10);
+    EXPECT(rendered == "No leaderboard data available.\n");
+}
+
+// `count` rows with clashing scores spread over the three difficulties.
+string leaderboardCsv(size_t count, size_t seed) {
+    string csv = kLeaderboardHeader;
+    for (size_t i = 0; i < count; ++i) {
+        size_t key = i * 7919 + seed;
+        csv += to_string(i + 1) + ",p" + to_string(seed) + "_" + to_string(i) + "," + to_string(key % 97) + ",1,1,5.00,"
+               + to_string(key % 13) + ".50,2.00," + to_string(1 + key % 3) + "," + to_string(kEpoch + i) + "\n";
+    }
+    return csv;
+}
+
+vector<string> namesOf(const vector<LeaderboardEntry> &rows) {
+    vector<string> names;
+    for (const LeaderboardEntry &entry : rows) {
+        names.push_back(entry.name);
+    }
+    return names;
+}
+
+void testPageAndAroundQueries() {
+    string path = scratchPath("pages.csv");
+    writeFile(path, leaderboardCsv(50, 1));
+    WordScrambleGame game;
+    EXPECT(game.loadLeaderboardFromFile(path));
+    vector<LeaderboardEntry> all = game.leaderboardTop(100);
+    EXPECT(all.size() == 50);
+    for (size_t i = 0; i < all.size(); ++i) {
+        EXPECT(all[i].rank == static_cast<int>(i + 1));
+        EXPECT(game.leaderboardRankOf(all[i].name) == i + 1);
+    }
+    vector<LeaderboardEntry> page = game.leaderboardPage(45, 10);
+    EXPECT(namesOf(page) == namesOf(vector<LeaderboardEntry>(all.begin() + 45, all.end())));
+    EXPECT(page.front().rank == 46);
+    EXPECT(game.leaderboardPage(50, 10).empty());
+    EXPECT(game.leaderboardPage(10, 0).empty());
+
+    vector<LeaderboardEntry> around = game.leaderboardAround(all[20].name, 3);
+    EXPECT(namesOf(around) == namesOf(vector<LeaderboardEntry>(all.begin() + 17, all.begin() + 24)));
+    EXPECT(around.front().rank == 18);
+    EXPECT(namesOf(game.leaderboardAround(all[1].name, 3)) == namesOf(vector<LeaderboardEntry>(all.begin(), all.begin() + 5)));
+    EXPECT(game.leaderboardAround(all[49].name, 2).size() == 3);
+    EXPECT(game.leaderboardAround("nobody", 3).empty());
+}
+
+// Each difficulty view is the global ranking filtered to that level, with its own ranks.
+void testDifficultyViewsFilterGlobalRanking() {
+    string path = scratchPath("levels.csv");
+    writeFile(path, leaderboardCsv(90, 2));
+    WordScrambleGame game;
+    EXPECT(game.loadLeaderboardFromFile(path));
+    vector<LeaderboardEntry> all = game.leaderboardTop(100);
+    size_t total = 0;
+    for (Difficulty level : {Difficulty::EASY, Difficulty::MEDIUM, Difficulty::HARD}) {
+        vector<LeaderboardEntry> expected;
+        copy_if(all.begin(), all.end(), back_inserter(expected), [&](const LeaderboardEntry &entry) {
+            return entry.difficulty == level;
+        });
+        vector<LeaderboardEntry> ranked = game.leaderboardPage(level, 0, 100);
+        EXPECT(namesOf(ranked) == namesOf(expected));
+        EXPECT(game.leaderboardSize(level) == expected.size());
+        for (size_t i = 0; i < ranked.size(); ++i) {
+            EXPECT(ranked[i].rank == static_cast<int>(i + 1));
+            EXPECT(game.leaderboardRankOf(ranked[i].name, level) == i + 1);
+        }
+        EXPECT(namesOf(game.leaderboardTop(level, 3)) == namesOf(vector<LeaderboardEntry>(expected.begin(), expected.begin() + 3)));
+        total += ranked.size();
+    }
+    EXPECT(total == all.size());
+    EXPECT(game.leaderboardRankOf(all[0].name, all[0].difficulty == Difficulty::EASY ? Difficulty::HARD : Difficulty::EASY) == 0);
+}
+
+// Rows that bypass the parser keep a strict weak order: NaN accuracy ranks
+// last within its score, and every row is found at its own rank.
+void testNanAccuracyRanksLast() {
+    for (SortAlgorithm algorithm : {SortAlgorithm::AUTO, SortAlgorithm::COMPARISON, SortAlgorithm::RADIX}) {
+        vector<LeaderboardEntry> rows;
+        for (int i = 0; i < 3000; ++i) {
+            LeaderboardEntry entry;
+            entry.name = "p" + to_string(i);
+            entry.score = i % 7;
+            entry.accuracy = i % 5 == 0 ? numeric_limits<double>::quiet_NaN() : static_cast<double>(i % 11);
+            entry.difficulty = Difficulty::EASY;
+            rows.push_back(entry);
+        }
+        LeaderboardStore store;
+        store.setSortAlgorithm(algorithm);
+        store.assign(vector<LeaderboardEntry>(rows));
+        const LeaderboardStore::RankedView &view = store.view(LeaderboardStore::kGlobalView);
+        for (size_t i = 0; i < view.slots.size(); ++i) {
+            const LeaderboardEntry &entry = *store.find(rows[view.slots[i]].name);
+            EXPECT(store.rankOf(entry.name) == i + 1);
+            if (i + 1 < view.slots.size()) {
+                const LeaderboardEntry &next = *store.find(rows[view.slots[i + 1]].name);
+                EXPECT(!LeaderboardStore::outranks(next, entry));
+                EXPECT(!(entry.score == next.score && std::isnan(entry.accuracy) && !std::isnan(next.accuracy)));
+            }
+        }
+    }
+}
+
+// Every view stays sorted and holds each row once while KEEP_LATEST rewrites
+// rows in place, including rows whose accuracy is NaN.
+void testUpsertKeepsViewsConsistent() {
+    LeaderboardStore store;
+    vector<LeaderboardEntry> rows;
+    for (int i = 0; i < 200; ++i) {
+        LeaderboardEntry entry;
+        entry.name = "p" + to_string(i);
+        entry.score = i % 9;
+        entry.accuracy = i % 4 == 0 ? numeric_limits<double>::quiet_NaN() : static_cast<double>(i % 13);
+        entry.difficulty = static_cast<Difficulty>(1 + i % 3);
+        entry.playedAt = 1767225600 + i * 3600;
+        rows.push_back(entry);
+    }
+    store.assign(vector<LeaderboardEntry>(rows));
+    mt19937 rng(5);
+    for (int round = 0; round < 2000; ++round) {
+        LeaderboardEntry entry = rows[rng() % rows.size()];
+        entry.score = static_cast<int>(rng() % 9);
+        entry.accuracy = rng() % 3 == 0 ? numeric_limits<double>::quiet_NaN() : static_cast<double>(rng() % 13);
+        entry.difficulty = static_cast<Difficulty>(1 + rng() % 3);
+        store.upsert(entry, true);
+    }
+    size_t levelRows = 0;
+    for (size_t v = 0; v < LeaderboardStore::kViewCount; ++v) {
+        const vector<uint32_t> &slots = store.view(v).slots;
+        levelRows += v == LeaderboardStore::kGlobalView ? 0 : slots.size();
+        for (size_t i = 0; i < slots.size(); ++i) {
+            const LeaderboardEntry &entry = *store.find(rows[slots[i]].name);
+            EXPECT(store.rankOf(entry.name, store.view(v)) == i + 1);
+        }
+    }
+    EXPECT(store.size() == rows.size());
+    EXPECT(levelRows == rows.size());
+}
+
+// A saved board lists rows by rank, so KEEP_LATEST has to pick each player's
+// row by playedAt rather than by file position, whether it collapses an
+// APPEND_ALL board on a mode switch or collapses the file as it loads.
+void testKeepLatestCollapsesByPlayedAt() {
+    string path = scratchPath("collapse_latest.csv");
+    writeFile(path, string(kLeaderboardHeader)
+                        + "1,bob,900,1,1,5.00,90.00,5.00,1," + to_string(kEpoch) + "\n"
+                        + "2,ann,800,1,1,5.00,90.00,5.00,1," + to_string(kEpoch + 2 * kDay) + "\n"
+                        + "3,bob,700,2,1,5.00,90.00,5.00,2," + to_string(kEpoch + 6 * kDay) + "\n"
+                        + "4,ann,600,2,1,5.00,90.00,5.00,1," + to_string(kEpoch + kDay) + "\n"
+                        + "5,cid,500,1,1,5.00,90.00,5.00,1,0\n"
+                        + "6,cid,400,2,1,5.00,90.00,5.00,1,0\n");
+    for (bool switchAfterLoad : {true, false}) {
+        WordScrambleGame game;
+        if (!switchAfterLoad) {
+            game.setLeaderboardMode(LeaderboardMode::KEEP_LATEST);
+        }
+        EXPECT(game.loadLeaderboardFromFile(path));
+        if (switchAfterLoad) {
+            game.setLeaderboardMode(LeaderboardMode::KEEP_LATEST);
+        }
+        EXPECT(game.leaderboardSize() == 3);
+        LeaderboardEntry entry;
+        EXPECT(game.findLeaderboardEntry("bob", entry) && entry.playedAt == kEpoch + 6 * kDay && entry.score == 700);
+        EXPECT(game.findLeaderboardEntry("ann", entry) && entry.playedAt == kEpoch + 2 * kDay && entry.score == 800);
+        // Without timestamps the later row wins.
+        EXPECT(game.findLeaderboardEntry("cid", entry) && entry.games == 2);
+        EXPECT(namesOf(game.leaderboardTop(10)) == (vector<string>{"ann", "bob", "cid"}));
+    }
+}
+
+// Each mode keeps the row a per-name map says it should, and the board is
+// ranked by the kept rows alone.
+void testUpsertModesKeepExpectedRow() {
+    for (bool keepLatest : {false, true}) {
+        LeaderboardStore store;
+        map<string, LeaderboardEntry> expected;
+        mt19937 rng(keepLatest ? 9 : 8);
+        for (int round = 0; round < 3000; ++round) {
+            LeaderboardEntry entry;
+            entry.name = "p" + to_string(rng() % 150);
+            entry.score = static_cast<int>(rng() % 40);
+            entry.accuracy = static_cast<double>(rng() % 5);
+            entry.games = round;
+            entry.difficulty = static_cast<Difficulty>(1 + rng() % 3);
+            auto found = expected.find(entry.name);
+            if (found == expected.end() || keepLatest || LeaderboardStore::outranks(entry, found->second)) {
+                expected[entry.name] = entry;
+            }
+            store.upsert(entry, keepLatest);
+        }
+        EXPECT(store.size() == expected.size());
+        vector<LeaderboardEntry> kept;
+        for (const auto &row : expected) {
+            const LeaderboardEntry *entry = store.find(row.first);
+            EXPECT(entry != nullptr && entry->games == row.second.games);
+            kept.push_back(row.second);
+        }
+        sort(kept.begin(), kept.end(), LeaderboardStore::outranks);
+        const LeaderboardStore::RankedView &view = store.view(LeaderboardStore::kGlobalView);
+        store.forEachInRange(view, 0, kept.size(), [&](const LeaderboardEntry &entry, size_t rank) {
+            EXPECT(entry.score == kept[rank - 1].score && entry.accuracy == kept[rank - 1].accuracy);
+        });
+    }
+}
+
+// The column mirror follows rows through upserts that move them between levels.
+void testColumnsTrackUpserts() {
+    LeaderboardStore store;
+    mt19937 rng(4);
+    for (int round = 0; round < 2000; ++round) {
+        LeaderboardEntry entry;
+        entry.name = "p" + to_string(rng() % 100);
+        entry.score = static_cast<int>(rng() % 500) - 100;
+        entry.accuracy = static_cast<double>(rng() % 100);
+        entry.averageTime = static_cast<double>(rng() % 30);
+        entry.difficulty = static_cast<Difficulty>(1 + rng() % 3);
+        store.upsert(entry, true);
+    }
+    for (Difficulty level : {Difficulty::EASY, Difficulty::MEDIUM, Difficulty::HARD}) {
+        double scoreSum = 0.0;
+        double accuracySum = 0.0;
+        double timeSum = 0.0;
+        int lowest = numeric_limits<int>::max();
+        const LeaderboardStore::RankedView &view = store.view(LeaderboardStore::viewFor(level));
+        store.forEachInRange(view, 0, view.slots.size(), [&](const LeaderboardEntry &entry, size_t) {
+            scoreSum += entry.score;
+            accuracySum += entry.accuracy;
+            timeSum += entry.averageTime;
+            lowest = min(lowest, entry.score);
+        });
+        double rows = static_cast<double>(view.slots.size());
+        LeaderboardAggregate aggregate = store.analytics().aggregate(level);
+        EXPECT(aggregate.count == view.slots.size());
+        EXPECT(aggregate.minScore == lowest);
+        EXPECT(std::fabs(aggregate.meanScore - scoreSum / rows) < 1e-9);
+        EXPECT(std::fabs(aggregate.meanAccuracy - accuracySum / rows) < 1e-9);
+        EXPECT(std::fabs(aggregate.meanAverageTime - timeSum / rows) < 1e-9);
+    }
+    EXPECT(store.analytics().aggregate().count == store.size());
+}
+
+template <typename T>
+void expectKernelsMatchScalar(const vector<T> &values, const vector<uint8_t> &levels) {
+    for (SimdLevel simd : {SimdLevel::SSE2, SimdLevel::AVX2}) {
+        // Every length up to a few vector widths exercises each tail path.
+        for (size_t rows = 0; rows <= values.size(); rows += rows < 80 ? 1 : 997) {
+            for (uint8_t level = 0; level <= 3; ++level) {
+                MaskedMoments scalar = ColumnKernels::moments(values.data(), levels.data(), rows, level, SimdLevel::SCALAR);
+                MaskedMoments wide = ColumnKernels::moments(values.data(), levels.data(), rows, level, simd);
+                EXPECT(wide.count == scalar.count);
+                EXPECT(wide.min == scalar.min && wide.max == scalar.max);
+                EXPECT(std::fabs(wide.sum - scalar.sum) <= 1e-9 * std::max(1.0, std::fabs(scalar.sum)));
+            }
+        }
+    }
+}
+
+void testSimdKernelsMatchScalar() {
+    mt19937 rng(6);
+    vector<int32_t> scores(3000);
+    vector<double> accuracies(3000);
+    vector<uint8_t> levels(3000);
+    for (size_t i = 0; i < scores.size(); ++i) {
+        scores[i] = static_cast<int32_t>(rng()) / (i % 2 == 0 ? 1 : 65536);
+        accuracies[i] = static_cast<double>(static_cast<int32_t>(rng() % 20001) - 10000) / 100.0;
+        levels[i] = static_cast<uint8_t>(1 + rng() % 3);
+    }
+    scores[17] = numeric_limits<int32_t>::min();
+    scores[18] = numeric_limits<int32_t>::max();
+    accuracies[5] = -0.0;
+    expectKernelsMatchScalar(scores, levels);
+    expectKernelsMatchScalar(accuracies, levels);
+    // NaN rows drop out of every kernel, whichever lane they land in.
+    for (size_t i = 3; i < accuracies.size(); i += 37) {
+        accuracies[i] = numeric_limits<double>::quiet_NaN();
+    }
+    expectKernelsMatchScalar(accuracies, levels);
+    vector<double> small{1, 2, 3, 5, 3, 4, 0.5, numeric_limits<double>::quiet_NaN(), 1.5};
+    vector<uint8_t> smallLevels(small.size(), 1);
+    for (SimdLevel simd : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        MaskedMoments moments = ColumnKernels::moments(small.data(), smallLevels.data(), small.size(), 0, simd);
+        EXPECT(moments.count == 8 && moments.sum == 20.0);
+        EXPECT(moments.min == 0.5 && moments.max == 5.0);
+    }
+}
+
+// Percentiles skip NaN too, so nth_element only ever sees ordered values.
+void testStatisticsSkipNaN() {
+    LeaderboardColumns columns;
+    const double nan = numeric_limits<double>::quiet_NaN();
+    for (double accuracy : {nan, 10.0, 20.0, 30.0, nan, 40.0}) {
+        LeaderboardEntry entry;
+        entry.accuracy = accuracy;
+        columns.append(entry);
+    }
+    ColumnSummary summary = columns.statistics(SimdLevel::SCALAR).accuracy;
+    EXPECT(summary.count == 4 && summary.mean == 25.0);
+    EXPECT(summary.min == 10.0 && summary.max == 40.0);
+    EXPECT(summary.p50 == 20.0 && summary.p90 == 40.0 && summary.p99 == 40.0);
+    EXPECT(columns.statistics(SimdLevel::AVX2).accuracy.max == 40.0);
+}
+
+vector<RankKey> randomRankKeys(size_t count, unsigned seed) {
+    mt19937 rng(seed);
+    vector<RankKey> keys(count);
+    for (size_t i = 0; i < count; ++i) {
+        keys[i].score = static_cast<int32_t>(rng() % 2000) - 1000;
+        keys[i].accuracy = static_cast<double>(rng() % 400) / 4.0;
+        keys[i].slot = static_cast<uint32_t>(i);
+    }
+    return keys;
+}
+
+// Odd worker counts leave an unpaired run in some merge rounds.
+void testParallelSortMatchesStdSort() {
+    vector<RankKey> expected = randomRankKeys(kParallelSortThreshold * 2 + 37, 10);
+    vector<RankKey> input = expected;
+    sort(expected.begin(), expected.end(), RankKeyOrder());
+    for (size_t workers : {1, 2, 3, 4, 5}) {
+        vector<RankKey> keys = input;
+        parallelSort(keys, RankKeyOrder(), workers);
+        EXPECT(keys.size() == expected.size());
+        EXPECT(equal(keys.begin(), keys.end(), expected.begin(),
+                     [](const RankKey &lhs, const RankKey &rhs) { return lhs.slot == rhs.slot; }));
+    }
+}
+
+// Accuracies that differ only below the packed key's 32 bits, signed zeros,
+// NaN and shuffled slots all go through the tie fix-up.
+void testRadixSortMatchesStdSort() {
+    const double inf = numeric_limits<double>::infinity();
+    const double specials[] = {0.0, -0.0, numeric_limits<double>::quiet_NaN(), inf, -inf, 1.0,
+                               nextafter(1.0, 2.0), -1.0, nextafter(-1.0, 0.0), numeric_limits<double>::denorm_min()};
+    mt19937 rng(11);
+    vector<RankKey> keys = randomRankKeys(20000, 12);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (i % 3 == 0) {
+            keys[i].accuracy = specials[rng() % size(specials)];
+        }
+        if (i % 7 == 0) {
+            keys[i].score = i % 2 == 0 ? numeric_limits<int32_t>::min() : numeric_limits<int32_t>::max();
+        }
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+    vector<RankKey> expected = keys;
+    sort(expected.begin(), expected.end(), RankKeyOrder());
+    radixSortRankKeys(keys);
+    EXPECT(equal(keys.begin(), keys.end(), expected.begin(),
+                 [](const RankKey &lhs, const RankKey &rhs) { return lhs.slot == rhs.slot; }));
+}
+
+// Merging saved shards ranks rows exactly as loading all of them at once, and
+// an unsorted shard, a missing file or an unwritable target fails the merge.
+void testShardMergeMatchesCombinedLoad() {
+    string combined = kLeaderboardHeader;
+    vector<string> shards;
+    for (size_t seed = 1; seed <= 4; ++seed) {
+        string csv = leaderboardCsv(40 * seed, seed);
+        combined += csv.substr(csv.find('\n') + 1);
+        string raw = scratchPath("shard_raw.csv");
+        writeFile(raw, csv);
+        WordScrambleGame shard;
+        EXPECT(shard.loadLeaderboardFromFile(raw));
+        shards.push_back(scratchPath("shard_" + to_string(seed) + ".csv"));
+        EXPECT(shard.saveLeaderboardToFile(shards.back()));
+    }
+    string combinedPath = scratchPath("shards_combined.csv");
+    writeFile(combinedPath, combined);
+    WordScrambleGame expected;
+    EXPECT(expected.loadLeaderboardFromFile(combinedPath));
+
+    WordScrambleGame merger;
+    string mergedPath = scratchPath("shards_merged.csv");
+    EXPECT(merger.mergeLeaderboardFiles(shards, mergedPath));
+    WordScrambleGame merged;
+    EXPECT(merged.loadLeaderboardFromFile(mergedPath));
+    EXPECT(merged.leaderboardSize() == expected.leaderboardSize());
+    EXPECT(namesOf(merged.leaderboardTop(1000)) == namesOf(expected.leaderboardTop(1000)));
+
+    // Failed merges leave the previous output in place and no staging file behind.
+    string before = readFile(mergedPath);
+    string unsorted = scratchPath("shard_unsorted.csv");
+    writeFile(unsorted, leaderboardCsv(40, 9));
+    EXPECT(!merger.mergeLeaderboardFiles({shards[0], unsorted}, mergedPath));
+    EXPECT(!merger.mergeLeaderboardFiles({shards[0], scratchPath("missing_shard.csv")}, mergedPath));
+    EXPECT(readFile(mergedPath) == before);
+    EXPECT(!filesystem::exists(mergedPath + ".tmp"));
+    EXPECT(!merger.mergeLeaderboardFiles(shards, scratchPath("no_such_directory/merged.csv")));
+}
+
+LeaderboardEntry rowWithScore(int score) {
+    LeaderboardEntry entry;
+    entry.name = "s" + to_string(score);
+    entry.score = score;
+    return entry;
+}
+
+void testScoreHistogramCapsBuckets() {
+    LeaderboardColumns columns;
+    for (int score : {3, 7, 7, 12}) {
+        columns.append(rowWithScore(score));
+    }
+    ScoreHistogram narrow = columns.scoreHistogram(5);
+    EXPECT(narrow.lowestScore == 3 && narrow.bucketWidth == 5);
+    EXPECT(narrow.counts == (vector<size_t>{3, 1}));
+
+    columns.clear();
+    columns.append(rowWithScore(-2000000000));
+    columns.append(rowWithScore(0));
+    columns.append(rowWithScore(2000000000));
+    ScoreHistogram wide = columns.scoreHistogram(1);
+    EXPECT(wide.counts.size() <= kMaxScoreBuckets);
+    EXPECT(wide.bucketWidth > 1);
+    EXPECT(wide.counts.front() == 1 && wide.counts.back() == 1);
+    EXPECT(accumulate(wide.counts.begin(), wide.counts.end(), size_t(0)) == 3);
+}
+
+void playAt(WordScrambleGame &game, const string &name, int64_t playedAt) {
+    game.setPlayerName(name);
+    game.updateLeaderboard(10.0, playedAt);
+}
+
+vector<string> windowNames(const WordScrambleGame &game, LeaderboardWindow window, int64_t at) {
+    vector<string> names;
+    for (const LeaderboardEntry &entry : game.leaderboardWindowPage(window, at, 0, 100)) {
+        names.push_back(entry.name);
+    }
+    return names;
+}
+
+// The live ring and the ring rebuilt on load both cover the newest period
+// present and the one before it, so every day and week answers the same after
+// a reload.
+void expectWindowsSurviveReload(WordScrambleGame &game, const string &file) {
+    string path = scratchPath(file);
+    EXPECT(game.saveLeaderboardToFile(path));
+    WordScrambleGame reloaded;
+    reloaded.setLeaderboardMode(game.getLeaderboardMode());
+    EXPECT(reloaded.loadLeaderboardFromFile(path));
+    for (int64_t day = 0; day < 21; ++day) {
+        int64_t at = kEpoch + day * kDay + 3600;
+        EXPECT(windowNames(game, LeaderboardWindow::DAILY, at) == windowNames(reloaded, LeaderboardWindow::DAILY, at));
+        EXPECT(windowNames(game, LeaderboardWindow::WEEKLY, at) == windowNames(reloaded, LeaderboardWindow::WEEKLY, at));
+    }
+}
+
+void testLeaderboardWindowsSurviveReload() {
+    WordScrambleGame game;
+    playAt(game, "ann", kEpoch + 10 * kDay);
+    playAt(game, "bea", kEpoch + 12 * kDay);
+    // Day 12 rolls the ring to days 11-12, so day 10 expires and a late day-11
+    // row still lands on the previous day's board.
+    playAt(game, "cid", kEpoch + 11 * kDay);
+    EXPECT(windowNames(game, LeaderboardWindow::DAILY, kEpoch + 11 * kDay) == vector<string>{"cid"});
+    EXPECT(game.leaderboardWindowSize(LeaderboardWindow::DAILY, kEpoch + 10 * kDay) == 0);
+    expectWindowsSurviveReload(game, "windows_append.csv");
+    // Rolling by one period keeps the newer bucket's rows as the previous day.
+    playAt(game, "dan", kEpoch + 13 * kDay);
+    EXPECT(windowNames(game, LeaderboardWindow::DAILY, kEpoch + 12 * kDay) == vector<string>{"bea"});
+    EXPECT(windowNames(game, LeaderboardWindow::DAILY, kEpoch + 13 * kDay) == vector<string>{"dan"});
+    EXPECT(game.leaderboardWindowSize(LeaderboardWindow::DAILY, kEpoch + 11 * kDay) == 0);
+    expectWindowsSurviveReload(game, "windows_append_rolled.csv");
+
+    WordScrambleGame latest;
+    latest.setLeaderboardMode(LeaderboardMode::KEEP_LATEST);
+    playAt(latest, "ann", kEpoch + 3 * kDay);
+    playAt(latest, "bea", kEpoch + 5 * kDay);
+    playAt(latest, "cid", kEpoch + 6 * kDay);
+    // cid moves to day 9: the ring rolls to days 8-9 and days 5 and 6 expire.
+    playAt(latest, "cid", kEpoch + 9 * kDay);
+    EXPECT(windowNames(latest, LeaderboardWindow::DAILY, kEpoch + 9 * kDay) == vector<string>{"cid"});
+    EXPECT(latest.leaderboardWindowSize(LeaderboardWindow::DAILY, kEpoch + 5 * kDay) == 0);
+    EXPECT(latest.leaderboardWindowSize(LeaderboardWindow::DAILY, kEpoch + 6 * kDay) == 0);
+    // Moving the only day-9 row to day 8 leaves day 9 empty instead of rescanning.
+    playAt(latest, "cid", kEpoch + 8 * kDay);
+    EXPECT(latest.leaderboardWindowSize(LeaderboardWindow::DAILY, kEpoch + 9 * kDay) == 0);
+    EXPECT(windowNames(latest, LeaderboardWindow::DAILY, kEpoch + 8 * kDay) == vector<string>{"cid"});
+    expectWindowsSurviveReload(latest, "windows_latest.csv");
+}
+
+// Windows in KEEP_BEST would only show the periods of all-time bests, so the
+// mode reports them unavailable and their queries come back empty.
+void testKeepBestHasNoWindows() {
+    WordScrambleGame game;
+    game.setLeaderboardMode(LeaderboardMode::KEEP_BEST);
+    EXPECT(!game.leaderboardWindowsAvailable());
+    playAt(game, "ann", kEpoch + 10 * kDay);
+    playAt(game, "ann", kEpoch + 11 * kDay);
+    EXPECT(game.leaderboardSize() == 1);
+    EXPECT(game.leaderboardWindowSize(LeaderboardWindow::DAILY, kEpoch + 10 * kDay) == 0);
+    EXPECT(game.leaderboardWindowSize(LeaderboardWindow::WEEKLY, kEpoch + 11 * kDay) == 0);
+    EXPECT(windowNames(game, LeaderboardWindow::DAILY, kEpoch + 11 * kDay).empty());
+    EXPECT(game.leaderboardWindowRankOf("ann", LeaderboardWindow::DAILY, kEpoch + 10 * kDay) == 0);
+
+    // Leaving KEEP_BEST rebuilds the windows from the row it kept.
+    game.setLeaderboardMode(LeaderboardMode::KEEP_LATEST);
+    EXPECT(game.leaderboardWindowsAvailable());
+    EXPECT(windowNames(game, LeaderboardWindow::DAILY, kEpoch + 10 * kDay) == vector<string>{"ann"});
+    playAt(game, "ann", kEpoch + 11 * kDay);
+    EXPECT(game.leaderboardWindowRankOf("ann", LeaderboardWindow::DAILY, kEpoch + 11 * kDay) == 1);
+}
+
+struct TestCase {
+    const char *name;
+    void (*run)();
+};
+
+const TestCase kTests[] = {
+    {"latency histogram percentiles", testLatencyHistogramPercentiles},
+    {"format duration units", testFormatDurationUnits},
+    {"metrics clock", testMetricsClock},
+    {"prometheus export syntax", testPrometheusExportSyntax},
+    {"JSON export round-trips", testJsonExportRoundTrips},
+    {"metrics buffer clamps non-finite", testMetricsBufferClampsNonFinite},
+    {"chrome trace shape", testChromeTraceShape},
+    {"trace buffer is bounded", testTraceBufferIsBounded},
+    {"aligned allocations are tracked", testAlignedAllocationsAreTracked},
+    {"bloom filter false positive rate", testBloomFilterFalsePositiveRate},
+    {"dedup filter matches unfiltered addWord", testDedupFilterMatchesUnfilteredAddWord},
+    {"multiplyHigh", testMultiplyHigh},
+    {"anagram index matches brute force", testAnagramIndexMatchesBruteForce},
+    {"letter signature", testLetterSignature},
+    {"word builder matches brute force", testWordBuilderMatchesBruteForce},
+    {"flat word set matches std set", testFlatWordSetMatchesStdSet},
+    {"corrupt compact dictionary is rejected", testCorruptCompactDictionaryIsRejected},
+    {"compact dictionary caps word length", testCompactDictionaryCapsWordLength},
+    {"compact dictionary skips short words", testCompactDictionarySkipsShortWords},
+    {"compact dictionary answers anagram queries", testCompactDictionaryAnswersAnagramQueries},
+    {"hint mask covers longest word", testHintMaskCoversLongestWord},
+    {"hint kinds return structured results", testHintKindsReturnStructuredResults},
+    {"non-finite leaderboard rows are skipped", testNonFiniteLeaderboardRowsAreSkipped},
+    {"non-finite round time is rejected", testNonFiniteRoundTimeIsRejected},
+    {"rendered leaderboard matches streams", testRenderedLeaderboardMatchesStreams},
+    {"page and around queries", testPageAndAroundQueries},
+    {"difficulty views filter global ranking", testDifficultyViewsFilterGlobalRanking},
+    {"NaN accuracy ranks last", testNanAccuracyRanksLast},
+    {"upsert modes keep expected row", testUpsertModesKeepExpectedRow},
+    {"KEEP_LATEST collapses by playedAt", testKeepLatestCollapsesByPlayedAt},
+    {"upsert keeps views consistent", testUpsertKeepsViewsConsistent},
+    {"leaderboard windows survive reload", testLeaderboardWindowsSurviveReload},
+    {"KEEP_BEST has no windows", testKeepBestHasNoWindows},
+    {"columns track upserts", testColumnsTrackUpserts},
+    {"SIMD kernels match scalar", testSimdKernelsMatchScalar},
+    {"statistics skip NaN", testStatisticsSkipNaN},
+    {"parallel sort matches std::sort", testParallelSortMatchesStdSort},
+    {"radix sort matches std::sort", testRadixSortMatchesStdSort},
+    {"shard merge matches combined load", testShardMergeMatchesCombinedLoad},
+    {"score histogram caps buckets", testScoreHistogramCapsBuckets},
+};
+
+} // namespace
+
+int main() {
+    for (const TestCase &test : kTests) {
+        int before = failures;
+        test.run();
+        std::printf("%s %s\n", failures == before ? "PASS" : "FAIL", test.name);
+    }
+    return failures;
+}